@@ -62,6 +62,9 @@
 // Maximum pass count.
 #define MR_MAX_PASSES           100
 
+// Maximum number of routing threads.
+#define MR_MAX_THREADS          32
+
 // Define types of via checkerboard patterns.
 enum VIA_PATTERN
 {
@@ -226,6 +229,8 @@ public:
     virtual void    setMapType(u_int) = 0;
     virtual u_int   ripLimit() = 0;
     virtual void    setRipLimit(u_int) = 0;
+    virtual u_int   numThreads() = 0;
+    virtual void    setNumThreads(u_int) = 0;
 
     virtual void    registerGraphics(mrGraphics*) = 0;
 };
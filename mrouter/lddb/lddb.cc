@@ -48,6 +48,7 @@
 #include <errno.h>
 #include <math.h>
 #include <algorithm>
+#include <pthread.h>
 #include "lddb_prv.h"
 #include "ld_hash.h"
 
@@ -638,6 +639,13 @@ cLDDB::emitError(const char *fmt, ...)
 }
 
 
+namespace {
+    // The router may emit messages from several threads, the
+    // message channels are not reentrant.
+    pthread_mutex_t mesg_mtx = PTHREAD_MUTEX_INITIALIZER;
+}
+
+
 // Print a message to the error channel.
 //
 void
@@ -650,8 +658,10 @@ cLDDB::emitErrMesg(const char *fmt, ...)
     va_start(args, fmt);
     vsnprintf(buf, 2048, fmt, args);
     va_end(args);
+    pthread_mutex_lock(&mesg_mtx);
     db_io->emitErrMesg(buf);
     db_io->flushErrMesg();
+    pthread_mutex_unlock(&mesg_mtx);
 }
 
 
@@ -660,8 +670,11 @@ cLDDB::emitErrMesg(const char *fmt, ...)
 void
 cLDDB::flushErrMesg()
 {
-    if (db_io)
+    if (db_io) {
+        pthread_mutex_lock(&mesg_mtx);
         db_io->flushErrMesg();
+        pthread_mutex_unlock(&mesg_mtx);
+    }
 }
 
 
@@ -677,7 +690,9 @@ cLDDB::emitMesg(const char *fmt, ...)
     va_start(args, fmt);
     vsnprintf(buf, 2048, fmt, args);
     va_end(args);
+    pthread_mutex_lock(&mesg_mtx);
     db_io->emitMesg(buf);
+    pthread_mutex_unlock(&mesg_mtx);
 }
 
 
@@ -686,8 +701,11 @@ cLDDB::emitMesg(const char *fmt, ...)
 void
 cLDDB::flushMesg()
 {
-    if (db_io)
+    if (db_io) {
+        pthread_mutex_lock(&mesg_mtx);
         db_io->flushMesg();
+        pthread_mutex_unlock(&mesg_mtx);
+    }
 }
 
 
@@ -310,6 +310,11 @@ cMRouter::cmdSet(const char *cmd)
         lstr.add(viaPattern() == VIA_PATTERN_NORMAL ? "normal" : "inverted");
         lstr.add_c('\n');
 
+        sprintf(buf, fmt, "threads");
+        lstr.add(buf);
+        sprintf(buf, "%u\n", numThreads());
+        lstr.add(buf);
+
         setDoneMsg(lstr.string_trim());
         return (LD_OK);
     }
@@ -519,6 +524,44 @@ cMRouter::cmdSet(const char *cmd)
         }
         return (LD_OK);
     }
+    if (!strcasecmp(tok, "threads")) {
+        // The number of threads used in first-stage routing.  Nets
+        // whose search areas don't overlap are routed concurrently,
+        // the result is the same as when routing with one thread.
+
+        delete [] tok;
+        tok = lstring::gettok(&s);
+        if (!tok) {
+            sprintf(buf, "threads: %u", numThreads());
+            setDoneMsg(lstring::copy(buf));
+        }
+        else {
+            if (isdigit(*tok)) {
+                u_int i = atoi(tok);
+                if (i > MR_MAX_THREADS) {
+                    setErrMsg(write_msg("too many threads %u, limit %u.",
+                        i, MR_MAX_THREADS));
+                    delete [] tok;
+                    return (LD_BAD);
+                }
+                if (i == 0) {
+                    setErrMsg(write_msg(
+                        "bad value %s, expecting positive integer.", tok));
+                    delete [] tok;
+                    return (LD_BAD);
+                }
+                setNumThreads(i);
+            }
+            else {
+                setErrMsg(write_msg(
+                    "bad value %s, expecting positive integer.", tok));
+                delete [] tok;
+                return (LD_BAD);
+            }
+            delete [] tok;
+        }
+        return (LD_OK);
+    }
     delete [] tok;
     return (db->cmdSet(cmd));
 }
@@ -728,6 +771,8 @@ cMRouter::cmdUnset(const char *cmd)
             setStackedVias(-1);
         else if (!strcasecmp(tok, "via_pattern"))
             setViaPattern(VIA_PATTERN_NONE);
+        else if (!strcasecmp(tok, "threads"))
+            setNumThreads(1);
 
         else if (!strcasecmp(tok, "segcost"))
             setSegCost(MR_SEGCOST);
@@ -55,6 +55,7 @@
 
 #include "mrouter_prv.h"
 #include "miscutil/tvals.h"
+#include "miscutil/threadpool.h"
 #ifdef LD_MEMDBG
 #include "miscutil/coresize.h"
 #endif
@@ -106,6 +107,7 @@ cMRouter::cMRouter(cLDDBif *d) : cLDDBref(d)
     mr_rmaskIncs        = 0;
     mr_curNet           = 0;
     mr_route_gen        = 0;
+    mr_master           = 0;
 
     mr_totalRoutes      = 0;
     mr_mask             = MASK_AUTO;
@@ -133,6 +135,7 @@ cMRouter::cMRouter(cLDDBif *d) : cLDDBref(d)
     mr_mapType          = MAP_OBSTRUCT | DRAW_ROUTES;
     mr_ripLimit         = 10;
     mr_rmaskIncsSz      = 0;
+    mr_numThreads       = 1;
     mr_graphics         = 0;
 
     if (d) {
@@ -145,8 +148,80 @@ cMRouter::cMRouter(cLDDBif *d) : cLDDBref(d)
 }
 
 
+// Private constructor for a worker used in multi-threaded routing. 
+// The worker shares the net list and the Obs and node info arrays
+// with the master, but has its own Obs2, listed, and mask arrays. 
+// The master must be initialized.
+//
+// The worker arrays are not cleared here.  Only the region of the
+// net being routed is set up and used (see grid_bounds), so pages
+// outside of the regions are never touched.
+//
+cMRouter::cMRouter(cMRouter *mr) : cLDDBref(mr->db)
+{
+    mr_layers           = new mrLayer[numLayers()];
+    for (u_int i = 0; i < numLayers(); i++) {
+        u_int sz = numChannelsX(i) * numChannelsY(i);
+        mr_layers[i].obs = mr->obsAry(i);
+        mr_layers[i].nodeinfo = mr->nodeInfoAry(i);
+        mr_layers[i].obs2 = new mrProute[sz];
+        mr_layers[i].listed = new bool[sz];
+    }
+    mr_nets             = mr->mr_nets;
+    u_int sz = numChannelsX(0) * numChannelsY(0);
+    mr_rmask            = new u_char[sz];
+    mr_rmaskIncs        = mr->mr_rmaskIncs;
+    mr_curNet           = 0;
+    mr_route_gen        = 0;
+    mr_master           = mr;
+
+    mr_totalRoutes      = 0;
+    mr_mask             = mr->mr_mask;
+    mr_pinLayers        = mr->mr_pinLayers;
+    mr_net_order        = mr->mr_net_order;
+
+    mr_ni_blks          = 0;
+    mr_ni_cnt           = 0;
+
+    mr_segCost          = mr->mr_segCost;
+    mr_viaCost          = mr->mr_viaCost;
+    mr_jogCost          = mr->mr_jogCost;
+    mr_xverCost         = mr->mr_xverCost;
+    mr_blockCost        = mr->mr_blockCost;
+    mr_offsetCost       = mr->mr_offsetCost;
+    mr_conflictCost     = mr->mr_conflictCost;
+
+    mr_numPasses        = mr->mr_numPasses;
+    mr_stackedVias      = mr->mr_stackedVias;
+    mr_viaPattern       = mr->mr_viaPattern;
+
+    mr_stepnet          = -1;
+    mr_initialized      = true;
+    mr_forceRoutable    = mr->mr_forceRoutable;
+    mr_keepTrying       = mr->mr_keepTrying;
+    mr_mapType          = mr->mr_mapType;
+    mr_ripLimit         = mr->mr_ripLimit;
+    mr_rmaskIncsSz      = mr->mr_rmaskIncsSz;
+    mr_numThreads       = 1;
+    mr_graphics         = 0;
+}
+
+
 cMRouter::~cMRouter()
 {
+    if (mr_master) {
+        // Shared with the master, don't free these.
+        for (u_int i = 0; i < numLayers(); i++) {
+            mr_layers[i].obs = 0;
+            mr_layers[i].nodeinfo = 0;
+        }
+        mr_nets = 0;
+        mr_rmaskIncs = 0;
+
+        // Node info allocated here is referenced from the shared
+        // array, the master takes these.
+        mr_master->adopt_nodeInfo(this);
+    }
     delete [] mr_layers;
     delete [] mr_nets;
     delete [] mr_rmask;
@@ -620,30 +695,37 @@ cMRouter::doFirstStage(bool graphdebug, int debug_netnum)
     if (debug() & LD_DBG_FLGS)
         printFlags("flags2");
 
-    for (u_int i = (debug_netnum >= 0) ? debug_netnum : 0; i < numNets();
-            i++) {
-
-        dbNet *net = get_net_to_route(i);
-        if (net && net->netnodes) {
-            if (doRoute(net, mrStage1, graphdebug) == LD_OK) {
-                remaining--;
-                if (verbose() > 0)
-                    db->emitMesg("Finished routing net %s\n", net->netname);
-                db->emitMesg("Nets remaining: %d\n", remaining);
+    if (numThreads() > 1 && debug_netnum < 0 && !graphdebug &&
+            mr_mask != MASK_NONE)
+        first_stage_mt(&remaining);
+    else {
+        for (u_int i = (debug_netnum >= 0) ? debug_netnum : 0; i < numNets();
+                i++) {
+
+            dbNet *net = get_net_to_route(i);
+            if (net && net->netnodes) {
+                if (doRoute(net, mrStage1, graphdebug) == LD_OK) {
+                    remaining--;
+                    if (verbose() > 0) {
+                        db->emitMesg("Finished routing net %s\n",
+                            net->netname);
+                    }
+                    db->emitMesg("Nets remaining: %d\n", remaining);
+                }
+                else {
+                    if (verbose() > 0)
+                        db->emitMesg("Failed to route net %s\n", net->netname);
+                }
             }
             else {
-                if (verbose() > 0)
-                    db->emitMesg("Failed to route net %s\n", net->netname);
-            }
-        }
-        else {
-            if (net && (verbose() > 0)) {
-                db->emitMesg("Nothing to do for net %s\n", net->netname);
+                if (net && (verbose() > 0)) {
+                    db->emitMesg("Nothing to do for net %s\n", net->netname);
+                }
+                remaining--;
             }
-            remaining--;
+            if (debug_netnum >= 0)
+                break;
         }
-        if (debug_netnum >= 0)
-            break;
     }
     int failcount = mr_failedNets.num_elements();
     if (debug_netnum >= 0)
@@ -668,6 +750,271 @@ cMRouter::doFirstStage(bool graphdebug, int debug_netnum)
 }
 
 
+namespace {
+    // Per-thread data for multi-threaded routing, each thread has a
+    // worker router.
+    //
+    struct mrThreadData : public sTPthreadData
+    {
+        mrThreadData(cMRouter *w)   { worker = w; }
+        ~mrThreadData()             { delete worker; }
+
+        cMRouter *worker;
+    };
+
+    // A net to route in stage 1 and its result.
+    //
+    struct mrRouteJob
+    {
+        dbNet   *net;
+        mrRegion inner;         // Area reachable by the search.
+        mrRegion outer;         // Above plus guard.
+        bool    serial;         // Can't confine, route in main router.
+        bool    result;
+    };
+}
+
+
+// first_stage_mt
+//
+// Multi-threaded first-stage routing.  Nets are taken in routing
+// order and gathered into batches, where the region of a net must not
+// overlap the region of any other net in the batch, or of any earlier
+// net not yet routed.  The nets of a batch are routed concurrently by
+// worker routers that are confined to the region.  Since a net sees
+// exactly the obstructions it would see if routing in order, the
+// result is the same as serial routing, for any thread count.  Nets
+// that can't be confined are routed serially.
+//
+void
+cMRouter::first_stage_mt(int *remaining)
+{
+    u_int nthr = numThreads();
+    if (nthr > MR_MAX_THREADS)
+        nthr = MR_MAX_THREADS;
+
+    mrRouteJob *jobs = new mrRouteJob[numNets()];
+    int njobs = 0;
+    for (u_int i = 0; i < numNets(); i++) {
+        dbNet *net = get_net_to_route(i);
+        if (net && net->netnodes) {
+            mrRouteJob *job = jobs + njobs++;
+            job->net = net;
+            job->serial = !net_region(net, &job->inner);
+            job->outer = mrRegion(job->inner.x1 - MR_PAR_GUARD,
+                job->inner.y1 - MR_PAR_GUARD, job->inner.x2 + MR_PAR_GUARD,
+                job->inner.y2 + MR_PAR_GUARD);
+            job->result = LD_BAD;
+        }
+        else {
+            if (net && (verbose() > 0)) {
+                db->emitMesg("Nothing to do for net %s\n", net->netname);
+            }
+            (*remaining)--;
+        }
+    }
+
+    cThreadPool *pool = new cThreadPool(nthr - 1);
+    u_int nwrk = pool->num_threads() + 1;
+    cMRouter **workers = new cMRouter*[nwrk];
+    for (u_int i = 0; i < nwrk - 1; i++) {
+        workers[i] = new cMRouter(this);
+        pool->setThreadData(new mrThreadData(workers[i]), i);
+    }
+    workers[nwrk - 1] = new cMRouter(this);
+    mrThreadData *mdata = new mrThreadData(workers[nwrk - 1]);
+
+    // Nets are considered for a batch from a window of pending nets,
+    // the batch size is limited so that workers stay balanced.
+
+    int wsize = 32*nwrk;
+    int bsize = 8*nwrk;
+    mrRouteJob **pend = new mrRouteJob*[njobs];
+    for (int i = 0; i < njobs; i++)
+        pend[i] = jobs + i;
+    mrRouteJob **batch = new mrRouteJob*[bsize];
+    mrRouteJob **skip = new mrRouteJob*[wsize];
+
+    int ph = 0;
+    while (ph < njobs) {
+        mrRouteJob *job = pend[ph];
+        int nb = 0;
+        if (job->serial) {
+            job->result = doRoute(job->net, mrStage1, false);
+            batch[nb++] = job;
+            ph++;
+        }
+        else {
+            int ns = 0;
+            int end = ph + wsize;
+            if (end > njobs)
+                end = njobs;
+            int i = ph;
+            for ( ; i < end && nb < bsize; i++) {
+                job = pend[i];
+                bool ok = !job->serial;
+                for (int j = 0; ok && j < ns; j++) {
+                    if (job->outer.intersects(skip[j]->outer))
+                        ok = false;
+                }
+                for (int j = 0; ok && j < nb; j++) {
+                    if (job->outer.intersects(batch[j]->outer))
+                        ok = false;
+                }
+                if (ok)
+                    batch[nb++] = job;
+                else {
+                    skip[ns++] = job;
+                    if (job->serial) {
+                        // Nothing beyond can be routed before this.
+                        i++;
+                        break;
+                    }
+                }
+            }
+
+            // Keep the skipped nets in order, ahead of the rest.
+            for (int j = ns - 1; j >= 0; j--)
+                pend[--i] = skip[j];
+
+            if (nb == 1)
+                batch[0]->result = doRoute(batch[0]->net, mrStage1, false);
+            else {
+                pool->clear();
+                for (int j = 0; j < nb; j++)
+                    pool->submit(route_job, batch[j]);
+                pool->run(mdata);
+
+                for (u_int j = 0; j < nwrk; j++) {
+                    mr_totalRoutes += workers[j]->mr_totalRoutes;
+                    workers[j]->mr_totalRoutes = 0;
+                }
+            }
+            ph += nb;
+        }
+
+        // Report in routing order.
+        for (int j = 0; j < nb; j++) {
+            job = batch[j];
+            if (nb > 1) {
+                if (job->result != LD_OK)
+                    mr_failedNets.push(job->net);
+                if (mr_graphics) {
+                    int lastlayer = -1;
+                    mr_graphics->draw_net(job->net, true, &lastlayer);
+                }
+            }
+            if (job->result == LD_OK) {
+                (*remaining)--;
+                if (verbose() > 0) {
+                    db->emitMesg("Finished routing net %s\n",
+                        job->net->netname);
+                }
+                db->emitMesg("Nets remaining: %d\n", *remaining);
+            }
+            else {
+                if (verbose() > 0) {
+                    db->emitMesg("Failed to route net %s\n",
+                        job->net->netname);
+                }
+            }
+        }
+    }
+
+    delete [] skip;
+    delete [] batch;
+    delete [] pend;
+    delete pool;
+    delete mdata;
+    delete [] workers;
+    delete [] jobs;
+}
+
+
+// Static function.
+// Thread work procedure, route a net in the thread's worker.
+//
+int
+cMRouter::route_job(sTPthreadData *tdata, void *arg)
+{
+    cMRouter *w = ((mrThreadData*)tdata)->worker;
+    mrRouteJob *job = (mrRouteJob*)arg;
+    w->mr_inner = job->inner;
+    w->mr_region = job->outer;
+    job->result = w->doRoute(job->net, mrStage1, false);
+
+    // The master keeps the failed list.
+    w->mr_failedNets.clear();
+    return (0);
+}
+
+
+// net_region
+//
+// Find the grid area that can be reached when routing net in stage
+// 1.  This contains the net bounding box, all node taps, and the
+// mask extent for the pass count.  Return false if
+// the net can't be confined, it must be routed with the full grid.
+//
+bool
+cMRouter::net_region(dbNet *net, mrRegion *rg)
+{
+    *rg = mrRegion(0, 0, numChannelsX(0) - 1, numChannelsY(0) - 1);
+
+    // Power buses use the full grid, and existing routes may be
+    // anywhere.
+    if ((net->flags & NET_GLOBAL) || net->routes)
+        return (false);
+
+    int slack;
+    if (mr_mask == MASK_AUTO)
+        slack = MASK_SMALL;
+    else if (mr_mask == MASK_BBOX)
+        slack = 0;
+    else if (mr_mask == MASK_NONE)
+        return (false);
+    else
+        slack = mr_mask;
+
+    // The trunk and branches are within the bounding box.
+    int x1 = net->xmin;
+    int y1 = net->ymin;
+    int x2 = net->xmax;
+    int y2 = net->ymax;
+    for (dbNode *node = net->netnodes; node; node = node->next) {
+        for (dbDpoint *dp = node->taps; dp; dp = dp->next) {
+            x1 = LD_MIN(x1, dp->gridx);
+            y1 = LD_MIN(y1, dp->gridy);
+            x2 = LD_MAX(x2, dp->gridx);
+            y2 = LD_MAX(y2, dp->gridy);
+        }
+        for (dbDpoint *dp = node->extend; dp; dp = dp->next) {
+            x1 = LD_MIN(x1, dp->gridx);
+            y1 = LD_MIN(y1, dp->gridy);
+            x2 = LD_MAX(x2, dp->gridx);
+            y2 = LD_MAX(y2, dp->gridy);
+        }
+    }
+
+    // The mask increments, as applied in create_mask.
+    int halo = slack;
+    for (u_int k = 1; k < numPasses(); k++) {
+        halo += mr_rmaskIncs ? ((k <= mr_rmaskIncsSz) ? mr_rmaskIncs[k-1] :
+            mr_rmaskIncs[mr_rmaskIncsSz - 1]) : 1;
+    }
+
+    if (x1 - halo > rg->x1)
+        rg->x1 = x1 - halo;
+    if (y1 - halo > rg->y1)
+        rg->y1 = y1 - halo;
+    if (x2 + halo < rg->x2)
+        rg->x2 = x2 + halo;
+    if (y2 + halo < rg->y2)
+        rg->y2 = y2 + halo;
+    return (true);
+}
+
+
 // doSecondStage
 //
 // Second stage:  Rip-up and reroute failing nets.
@@ -1694,16 +2041,86 @@ cMRouter::create_mask(dbNet *net, int slack, int halo)
 //
 // Fills the mr_rmask array with all 1s as a last resort, ensuring
 // that no valid routes are missed due to a bad guess about the
-// optimal route positions.
+// optimal route positions.  In a thread worker, only the region is
+// filled.
 //
 void
 cMRouter::fill_mask(int value)
 {
+    if (mr_master) {
+        mrRegion rg;
+        grid_bounds(0, &rg);
+        for (int y = rg.y1; y <= rg.y2; y++)
+            memset(mr_rmask + ogrid(rg.x1, y, 0), value, rg.x2 - rg.x1 + 1);
+        return;
+    }
     size_t sz = numChannelsX(0) * numChannelsY(0);
     memset(mr_rmask, value, sz);
 }
 
 
+// grid_bounds
+//
+// Set the grid area on layer that is set up for routing a net.  This
+// is the full layer, except in a thread worker, which is confined to
+// its region.
+//
+void
+cMRouter::grid_bounds(u_int layer, mrRegion *rg)
+{
+    rg->x1 = 0;
+    rg->y1 = 0;
+    rg->x2 = numChannelsX(layer) - 1;
+    rg->y2 = numChannelsY(layer) - 1;
+    if (mr_master) {
+        if (rg->x1 < mr_region.x1)
+            rg->x1 = mr_region.x1;
+        if (rg->y1 < mr_region.y1)
+            rg->y1 = mr_region.y1;
+        if (rg->x2 > mr_region.x2)
+            rg->x2 = mr_region.x2;
+        if (rg->y2 > mr_region.y2)
+            rg->y2 = mr_region.y2;
+    }
+}
+
+
+// clip_mask
+//
+// In a thread worker, surround the inner region with mask values
+// beyond the last pass, so that the search can't leave the region.
+// The region contains the full mask extent for the pass count, so
+// this does not change the routing result.
+//
+void
+cMRouter::clip_mask()
+{
+    int nx = numChannelsX(0);
+    int ny = numChannelsY(0);
+    u_int v = numPasses();
+    int x1 = mr_inner.x1 - 1;
+    int y1 = mr_inner.y1 - 1;
+    int x2 = mr_inner.x2 + 1;
+    int y2 = mr_inner.y2 + 1;
+    for (int x = x1; x <= x2; x++) {
+        if (x < 0 || x >= nx)
+            continue;
+        if (y1 >= 0)
+            setRmask(x, y1, v);
+        if (y2 < ny)
+            setRmask(x, y2, v);
+    }
+    for (int y = y1; y <= y2; y++) {
+        if (y < 0 || y >= ny)
+            continue;
+        if (x1 >= 0)
+            setRmask(x1, y, v);
+        if (x2 < nx)
+            setRmask(x2, y, v);
+    }
+}
+
+
 // unable_to_route
 //
 // Catch-all function when no tap points are found.  This is a common
@@ -1798,14 +2215,16 @@ cMRouter::next_route_setup(mrRouteInfo *iroute, mrStage stage)
         // will not be used for crossover costing of future routes.
 
         for (u_int i = 0; i < pinLayers(); i++) {
-            u_int sz = numChannelsX(i) * numChannelsY(i);
-            for (u_int j = 0; j < sz; j++) {
-                mrGridCell c;
-                c.layer = i;
-                c.index = j;
-                dbNode *node = nodeLoc(c);
-                if (node && node->netnum == (u_int)iroute->net->netnum)
-                    setNodeLoc(c, 0);
+            mrRegion rg;
+            grid_bounds(i, &rg);
+            for (int y = rg.y1; y <= rg.y2; y++) {
+                for (int x = rg.x1; x <= rg.x2; x++) {
+                    mrGridCell c;
+                    initGridCell(c, x, y, i);
+                    dbNode *node = nodeLoc(c);
+                    if (node && node->netnum == (u_int)iroute->net->netnum)
+                        setNodeLoc(c, 0);
+                }
             }
         }
 
@@ -1844,25 +2263,30 @@ mrRval
 cMRouter::route_setup(mrRouteInfo *iroute, mrStage stage, u_int *unrt)
 {
     // Make Obs2[][] a copy of Obs[][].  Convert pin obstructions to
-    // terminal positions for the net being routed.
+    // terminal positions for the net being routed.  A thread worker
+    // copies only its region, the search never leaves it.
 
     if (unrt)
         *unrt = 0;
     for (u_int i = 0; i < numLayers(); i++) {
-        u_int sz = numChannelsX(i) * numChannelsY(i);
-        for (u_int j = 0; j < sz; j++) {
-            u_int netnum = obsAry(i)[j] & (~BLOCKED_MASK);
-            mrProute *Pr = &obs2Ary(i)[j];
-            if (netnum != 0) {
-                Pr->flags = 0;            // Clear all flags
-                if (netnum == DRC_BLOCKAGE)
-                    Pr->prdata.net = netnum;
-                else
-                    Pr->prdata.net = netnum & NETNUM_MASK;
-            }
-            else {
-                Pr->flags = PR_COST;        // This location is routable.
-                Pr->prdata.cost = MAXRT;
+        mrRegion rg;
+        grid_bounds(i, &rg);
+        for (int y = rg.y1; y <= rg.y2; y++) {
+            u_int j = ogrid(rg.x1, y, i);
+            for (int x = rg.x1; x <= rg.x2; x++, j++) {
+                u_int netnum = obsAry(i)[j] & (~BLOCKED_MASK);
+                mrProute *Pr = &obs2Ary(i)[j];
+                if (netnum != 0) {
+                    Pr->flags = 0;            // Clear all flags
+                    if (netnum == DRC_BLOCKAGE)
+                        Pr->prdata.net = netnum;
+                    else
+                        Pr->prdata.net = netnum & NETNUM_MASK;
+                }
+                else {
+                    Pr->flags = PR_COST;        // This location is routable.
+                    Pr->prdata.cost = MAXRT;
+                }
             }
         }
     }
@@ -1982,15 +2406,17 @@ cMRouter::route_setup(mrRouteInfo *iroute, mrStage stage, u_int *unrt)
         // will not be used for crossover costing of future routes.
 
         for (u_int i = 0; i < pinLayers(); i++) {
-            u_int sz = numChannelsX(i) * numChannelsY(i);
-            for (u_int j = 0; j < sz; j++) {
-                mrGridCell c;
-                c.layer = i;
-                c.index = j;
-                iroute->nsrc = nodeLoc(c);
-                if (iroute->nsrc &&
-                        iroute->nsrc->netnum == (u_int)iroute->net->netnum)
-                    setNodeLoc(c, 0);
+            mrRegion rg;
+            grid_bounds(i, &rg);
+            for (int y = rg.y1; y <= rg.y2; y++) {
+                for (int x = rg.x1; x <= rg.x2; x++) {
+                    mrGridCell c;
+                    initGridCell(c, x, y, i);
+                    iroute->nsrc = nodeLoc(c);
+                    if (iroute->nsrc &&
+                            iroute->nsrc->netnum == (u_int)iroute->net->netnum)
+                        setNodeLoc(c, 0);
+                }
             }
         }
 
@@ -2011,6 +2437,8 @@ cMRouter::route_setup(mrRouteInfo *iroute, mrStage stage, u_int *unrt)
         create_bbox_mask(iroute->net, numPasses());
     else
         create_mask(iroute->net, mr_mask, numPasses());
+    if (mr_master)
+        clip_mask();
 
     // Heuristic:  Set the initial cost beyond which we stop
     // searching.  This value is twice the cost of a direct route
@@ -2100,9 +2528,19 @@ cMRouter::route_segs(mrRouteInfo *iroute, mrStage stage, bool graphdebug)
         }
 
         // Clear the 'listed' flags.  These are used when saving stack
-        // elements to prevent duplicate entries.
+        // elements to prevent duplicate entries.  A thread worker
+        // clears only its region.
 
         for (u_int l = 0; l < numLayers(); l++) {
+            if (mr_master) {
+                mrRegion rg;
+                grid_bounds(l, &rg);
+                for (int y = rg.y1; y <= rg.y2; y++) {
+                    memset(listedAry(l) + ogrid(rg.x1, y, l), 0,
+                        (rg.x2 - rg.x1 + 1)*sizeof(bool));
+                }
+                continue;
+            }
             int lsz = numChannelsX(0) * numChannelsY(0);
             memset(listedAry(l), 0, lsz*sizeof(bool));
         }
@@ -2471,6 +2909,30 @@ cMRouter::new_nodeInfo()
 }
 
 
+// Take ownership of the mrNodeInfo blocks allocated by a worker.  The
+// master's current block remains at the head of the list.
+//
+void
+cMRouter::adopt_nodeInfo(cMRouter *w)
+{
+    niBlk *wb = w->mr_ni_blks;
+    if (!wb)
+        return;
+    w->mr_ni_blks = 0;
+    if (!mr_ni_blks) {
+        mr_ni_blks = wb;
+        mr_ni_cnt = w->mr_ni_cnt;
+        w->mr_ni_cnt = 0;
+        return;
+    }
+    niBlk *x = wb;
+    while (x->next)
+        x = x->next;
+    x->next = mr_ni_blks->next;
+    mr_ni_blks->next = wb;
+}
+
+
 // Free all blocks.
 //
 void
@@ -221,14 +221,11 @@ struct mrPoint
 #define PR_COST         0x80    // If set, use prdata.cost, not prdata.net.
 // Partial route.
 //
+// There is no constructor, the arrays are cleared where allocated,
+// except in a thread worker which initializes only its region.
+//
 struct mrProute
 {
-    mrProute()
-        {
-            flags       = 0;
-            prdata.cost = 0;
-        }
-
     u_int   flags;      // Values PR_PROCESSED and PR_CONFLICT, and others.
     union {
         u_int cost;     // Cost of route coming from predecessor.
@@ -356,6 +353,25 @@ struct mrLayer
     mrNodeInfo **nodeinfo;  // Stub/offset information.
 };
 
+// Rectangular area of the wire-channel grid, used to confine
+// routing threads.
+//
+struct mrRegion
+{
+    mrRegion()                  { x1 = y1 = x2 = y2 = 0; }
+    mrRegion(int l, int b, int r, int t)
+                                { x1 = l; y1 = b; x2 = r; y2 = t; }
+
+    bool intersects(const mrRegion &r) const
+        { return (x1 <= r.x2 && r.x1 <= x2 && y1 <= r.y2 && r.y1 <= y2); }
+
+    int     x1, y1, x2, y2;
+};
+
+// Grid tracks added around the region of a net routed in a thread,
+// regions of nets routed concurrently are separated by twice this.
+#define MR_PAR_GUARD    4
+
 // Point in the wire-channel space.
 struct mrGridCell
 {
@@ -368,6 +384,9 @@ struct mrGridCell
 // Opaque physical path generator context.
 struct sPhysRouteGenCx;
 
+// Thread pool data, from miscutil/threadpool.h.
+struct sTPthreadData;
+
 // Main router class.
 //
 class cMRouter: public cMRif, public cLDDBref
@@ -620,11 +639,19 @@ public:
     void    setMapType(u_int t)         { mr_mapType = t; }
     u_int   ripLimit()                  { return (mr_ripLimit); }
     void    setRipLimit(u_int i)        { mr_ripLimit = i; }
+    u_int   numThreads()                { return (mr_numThreads); }
+    void    setNumThreads(u_int n)      { mr_numThreads = n; }
 
     void    registerGraphics(mrGraphics *g) { mr_graphics = g; }
 
 private:
     // mrouter.cc
+    cMRouter(cMRouter*);
+    void    first_stage_mt(int*);
+    static int route_job(sTPthreadData*, void*);
+    bool    net_region(dbNet*, mrRegion*);
+    void    grid_bounds(u_int, mrRegion*);
+    void    clip_mask();
     void    create_net_order();
     dbNet   *get_net_to_route(int);
     int     ripup_colliding(dbNet*);
@@ -640,6 +667,7 @@ private:
     mrRval  route_segs(mrRouteInfo*, mrStage, bool);
     void    printFlags(const char*);
     mrNodeInfo *new_nodeInfo();
+    void    adopt_nodeInfo(cMRouter*);
     void    clear_nodeInfo();
 
     // mr_maze.cc
@@ -713,6 +741,9 @@ private:
     dbNet   *mr_curNet;             // Current net to route, used by 2nd stage.
     mrNetList mr_failedNets;        // List of nets that failed to route.
     sPhysRouteGenCx *mr_route_gen;  // Physical route generator context.
+    cMRouter *mr_master;            // Owning router, when a thread worker.
+    mrRegion mr_inner;              // Worker routing area.
+    mrRegion mr_region;             // Worker routing area plus guard.
 
     u_int   mr_totalRoutes;
     u_int   mr_mask;                // MASK_TYPE or small integer.
@@ -743,6 +774,7 @@ private:
     u_char  mr_ripLimit;            // Fail net rather than rip up more than
                                     // this number of other nets.
     u_char  mr_rmaskIncsSz;         // Size of mask increments list.
+    u_char  mr_numThreads;          // Number of threads used in stage 1.
     mrGraphics *mr_graphics;        // optional graphics object.
 };
 
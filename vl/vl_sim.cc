@@ -1368,6 +1368,223 @@ vl_stack::print(ostream &outs)
 // End vl_stack functions
 
 
+// Return a pointer to the entry for st, or 0 if not in the set.
+//
+vl_stmt_set::ss_ent *
+vl_stmt_set::find(vl_stmt *st)
+{
+    if (!used)
+        return (0);
+    unsigned int mask = size - 1;
+    unsigned int i = (unsigned int)(((unsigned long)st >> 4) * 2654435761UL)
+        & mask;
+    for (;;) {
+        ss_ent *e = entries + i;
+        if (e->epoch != epoch)
+            return (0);
+        if (e->stmt == st)
+            return (e->count ? e : 0);
+        i = (i + 1) & mask;
+    }
+}
+
+
+// Add st to the set, incrementing the count if already present.
+//
+void
+vl_stmt_set::insert(vl_stmt *st)
+{
+    if (!st)
+        return;
+    if (2*(used + 1) > size)
+        rehash(size ? 2*size : 16);
+    unsigned int mask = size - 1;
+    unsigned int i = (unsigned int)(((unsigned long)st >> 4) * 2654435761UL)
+        & mask;
+    for (;;) {
+        ss_ent *e = entries + i;
+        if (e->epoch != epoch) {
+            e->stmt = st;
+            e->count = 1;
+            e->epoch = epoch;
+            used++;
+            return;
+        }
+        if (e->stmt == st) {
+            e->count++;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+
+// Decrement the count for st.  The entry remains as a place holder
+// until the next clear or rehash.
+//
+void
+vl_stmt_set::erase(vl_stmt *st)
+{
+    if (!st)
+        return;
+    ss_ent *e = find(st);
+    if (e)
+        e->count--;
+}
+
+
+void
+vl_stmt_set::clear()
+{
+    if (!used)
+        return;
+    used = 0;
+    epoch++;
+    if (!epoch) {
+        // wrapped, reset the table
+        for (unsigned int i = 0; i < size; i++)
+            entries[i].epoch = 0;
+        epoch = 1;
+    }
+}
+
+
+void
+vl_stmt_set::swap(vl_stmt_set *s)
+{
+    ss_ent *e = entries;
+    entries = s->entries;
+    s->entries = e;
+    unsigned int t = size;
+    size = s->size;
+    s->size = t;
+    t = used;
+    used = s->used;
+    s->used = t;
+    t = epoch;
+    epoch = s->epoch;
+    s->epoch = t;
+}
+
+
+// Resize the table, retaining only the live entries.
+//
+void
+vl_stmt_set::rehash(unsigned int nsize)
+{
+    ss_ent *oldents = entries;
+    unsigned int oldsize = size;
+    unsigned int oldepoch = epoch;
+    unsigned int live = 0;
+    for (unsigned int i = 0; i < oldsize; i++) {
+        if (oldents[i].epoch == oldepoch && oldents[i].count)
+            live++;
+    }
+    while (nsize > 16 && 4*live < nsize)
+        nsize >>= 1;
+    while (2*(live + 1) > nsize)
+        nsize <<= 1;
+
+    entries = new ss_ent[nsize];
+    for (unsigned int i = 0; i < nsize; i++) {
+        entries[i].stmt = 0;
+        entries[i].count = 0;
+        entries[i].epoch = 0;
+    }
+    size = nsize;
+    used = 0;
+    epoch = 1;
+    unsigned int mask = size - 1;
+    for (unsigned int j = 0; j < oldsize; j++) {
+        ss_ent *oe = oldents + j;
+        if (oe->epoch != oldepoch || !oe->count)
+            continue;
+        unsigned int i =
+            (unsigned int)(((unsigned long)oe->stmt >> 4) * 2654435761UL)
+            & mask;
+        while (entries[i].epoch == epoch)
+            i = (i + 1) & mask;
+        entries[i] = *oe;
+        entries[i].epoch = epoch;
+        used++;
+    }
+    delete [] oldents;
+}
+// End vl_stmt_set functions
+
+
+// Return the offset of the first slot with time not less than t, and
+// set found if the time matches.
+//
+int
+vl_tsindex::find(vl_time_t t, bool *found)
+{
+    int lo = 0, hi = num;
+    while (lo < hi) {
+        int mid = (lo + hi)/2;
+        if (slot(mid)->time < t)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    *found = (lo < num && slot(lo)->time == t);
+    return (lo);
+}
+
+
+// Insert ts at offset i.
+//
+void
+vl_tsindex::insert(int i, vl_timeslot *ts)
+{
+    if (i == 0 && start > 0) {
+        start--;
+        slots[start] = ts;
+        num++;
+        return;
+    }
+    if (start + num >= size) {
+        int nsize = size;
+        if (2*(num + 1) > size)
+            nsize = size ? 2*size : 16;
+        vl_timeslot **nslots = new vl_timeslot*[nsize];
+        for (int j = 0; j < num; j++)
+            nslots[j] = slots[start + j];
+        delete [] slots;
+        slots = nslots;
+        size = nsize;
+        start = 0;
+    }
+    for (int j = num; j > i; j--)
+        slots[start + j] = slots[start + j - 1];
+    slots[start + i] = ts;
+    num++;
+}
+
+
+// Remove ts, normally the first slot.
+//
+void
+vl_tsindex::remove(vl_timeslot *ts)
+{
+    if (num > 0 && slots[start] == ts) {
+        start++;
+        num--;
+        if (!num)
+            start = 0;
+        return;
+    }
+    bool found;
+    int i = find(ts->time, &found);
+    if (!found || slot(i) != ts)
+        return;
+    for (int j = i + 1; j < num; j++)
+        slots[start + j - 1] = slots[start + j];
+    num--;
+}
+// End vl_tsindex functions
+
+
 vl_timeslot::vl_timeslot(vl_time_t t) 
 {
     time = t;
@@ -1377,6 +1594,7 @@ vl_timeslot::vl_timeslot(vl_time_t t)
     nbau_actions = n_end = 0;
     mon_actions = m_end = 0;
     next = 0;
+    index = 0;
 }
 
 
@@ -1387,6 +1605,11 @@ vl_timeslot::~vl_timeslot()
     vl_action_item::destroy(zdly_actions);
     vl_action_item::destroy(nbau_actions);
     vl_action_item::destroy(mon_actions);
+    if (index) {
+        index->remove(this);
+        if (!index->num)
+            delete index;
+    }
 }
   
 // Return the list head corresponding to the indicated time
@@ -1401,10 +1624,18 @@ vl_timeslot::find_slot(vl_time_t t)
         // a dummy timeslot (it is the list head in the simulator) and
         // add a new slot with the previous contents.
 
-        vl_timeslot *ts = new vl_timeslot(*this);
+        vl_timeslot *ts = new vl_timeslot(time);
+        ts->swap_contents(this);
         ts->next = next;
-        *this = vl_timeslot(t);
         next = ts;
+        if (index) {
+            ts->index = index;
+            index->set_slot(0, ts);
+            time = t;
+            index->insert(0, this);
+        }
+        else
+            time = t;
         return (this);
 
         /*
@@ -1414,22 +1645,30 @@ vl_timeslot::find_slot(vl_time_t t)
         return (this);
         */
     }
-    vl_timeslot *s = this, *sp = 0;
-    while (s && s->time < t)
-        sp = s, s = s->next;
-    if (s) {
-        if (s->time > t) {
-            vl_timeslot *ts = new vl_timeslot(t);
-            ts->next = s;
-            sp->next = ts;
-            s = ts;
+    if (t == time)
+        return (this);
+
+    // Locate the slot with a binary search of the index, which is
+    // created on first use from the list.  The list head is always
+    // the first entry.
+    if (!index) {
+        vl_tsindex *ix = new vl_tsindex;
+        for (vl_timeslot *s = this; s; s = s->next) {
+            s->index = ix;
+            ix->insert(ix->num, s);
         }
     }
-    else {
-        sp->next = new vl_timeslot(t);
-        s = sp->next;
-    }
-    return (s);
+    bool found;
+    int i = index->find(t, &found);
+    if (found)
+        return (index->slot(i));
+    vl_timeslot *sp = index->slot(i - 1);
+    vl_timeslot *ts = new vl_timeslot(t);
+    ts->next = sp->next;
+    sp->next = ts;
+    ts->index = index;
+    index->insert(i, ts);
+    return (ts);
 }
 
 
@@ -1439,18 +1678,7 @@ void
 vl_timeslot::append(vl_time_t t, vl_action_item *a)
 {
     vl_timeslot *s = find_slot(t);
-    for (vl_action_item *aa = s->actions; aa; aa = aa->next) {
-        if (aa->stmt && aa->stmt == a->stmt) {
-            delete a;
-            return;
-        }
-    }
-    if (!s->actions)
-        s->actions = s->a_end = a;
-    else
-        s->a_end->next = a;
-    while (s->a_end->next)
-        s->a_end = s->a_end->next;
+    s->append_list(&s->actions, &s->a_end, &s->a_set, a);
 }
 
 
@@ -1460,18 +1688,7 @@ void
 vl_timeslot::append_trig(vl_time_t t, vl_action_item *a)
 {
     vl_timeslot *s = find_slot(t);
-    for (vl_action_item *aa = s->trig_actions; aa; aa = aa->next) {
-        if (aa->stmt && aa->stmt == a->stmt) {
-            delete a;
-            return;
-        }
-    }
-    if (!s->trig_actions)
-        s->trig_actions = s->t_end = a;
-    else
-        s->t_end->next = a;
-    while (s->t_end->next)
-        s->t_end = s->t_end->next;
+    s->append_list(&s->trig_actions, &s->t_end, &s->t_set, a);
 }
 
 
@@ -1481,18 +1698,7 @@ void
 vl_timeslot::append_zdly(vl_time_t t, vl_action_item *a)
 {
     vl_timeslot *s = find_slot(t);
-    for (vl_action_item *aa = s->zdly_actions; aa; aa = aa->next) {
-        if (aa->stmt && aa->stmt == a->stmt) {
-            delete a;
-            return;
-        }
-    }
-    if (!s->zdly_actions)
-        s->zdly_actions = s->z_end = a;
-    else
-        s->z_end->next = a;
-    while (s->z_end->next)
-        s->z_end = s->z_end->next;
+    s->append_list(&s->zdly_actions, &s->z_end, &s->z_set, a);
 }
 
 
@@ -1502,18 +1708,7 @@ void
 vl_timeslot::append_nbau(vl_time_t t, vl_action_item *a)
 {
     vl_timeslot *s = find_slot(t);
-    for (vl_action_item *aa = s->nbau_actions; aa; aa = aa->next) {
-        if (aa->stmt && aa->stmt == a->stmt) {
-            delete a;
-            return;
-        }
-    }
-    if (!s->nbau_actions)
-        s->nbau_actions = s->n_end = a;
-    else
-        s->n_end->next = a;
-    while (s->n_end->next)
-        s->n_end = s->n_end->next;
+    s->append_list(&s->nbau_actions, &s->n_end, &s->n_set, a);
 }
 
 
@@ -1523,18 +1718,32 @@ void
 vl_timeslot::append_mon(vl_time_t t, vl_action_item *a)
 {
     vl_timeslot *s = find_slot(t);
-    for (vl_action_item *aa = s->mon_actions; aa; aa = aa->next) {
-        if (aa->stmt && aa->stmt == a->stmt) {
-            delete a;
-            return;
-        }
+    s->append_list(&s->mon_actions, &s->m_end, &s->m_set, a);
+}
+
+
+// Append a to the list, unless the list already contains the
+// statement.  The set tracks the statements in the list, so no scan
+// is needed.
+//
+void
+vl_timeslot::append_list(vl_action_item **list, vl_action_item **end,
+    vl_stmt_set *set, vl_action_item *a)
+{
+    if (set->contains(a->stmt)) {
+        delete a;
+        return;
+    }
+    if (!*list) {
+        *list = *end = a;
+        set->insert(a->stmt);
     }
-    if (!s->mon_actions)
-        s->mon_actions = s->m_end = a;
     else
-        s->m_end->next = a;
-    while (s->m_end->next)
-        s->m_end = s->m_end->next;
+        (*end)->next = a;
+    while ((*end)->next) {
+        *end = (*end)->next;
+        set->insert((*end)->stmt);
+    }
 }
 
 
@@ -1551,17 +1760,21 @@ vl_timeslot::eval_slot(vl_simulator *sim)
         if (sim->stop != VLrun)
             break;
         if (!actions) {
+            a_set.clear();
             if (zdly_actions) {
                 actions = zdly_actions;
                 zdly_actions = 0;
+                a_set.swap(&z_set);
             }
             else if (nbau_actions) {
                 actions = nbau_actions;
                 nbau_actions = 0;
+                a_set.swap(&n_set);
             }
             else if (mon_actions) {
                 actions = mon_actions;
                 mon_actions = 0;
+                a_set.swap(&m_set);
             }
             else
                 break;
@@ -1578,8 +1791,13 @@ vl_timeslot::add_next_actions(vl_simulator *sim)
 {
     if (sim->next_actions) {
         vl_action_item *a = sim->next_actions;
-        while (a->next)
+        a_set.insert(a->stmt);
+        while (a->next) {
             a = a->next;
+            a_set.insert(a->stmt);
+        }
+        if (!actions)
+            a_end = a;
         a->next = actions;
         actions = sim->next_actions;
         sim->next_actions = 0;
@@ -1622,6 +1840,7 @@ vl_timeslot::do_actions(vl_simulator *sim)
     acts[sp].actions = actions;
     acts[sp].type = Fence;
     actions = 0;
+    a_set.clear();
     bool doing_trig = false;
     int trig_sp = 0;
 
@@ -1666,6 +1885,7 @@ vl_timeslot::do_actions(vl_simulator *sim)
             do {
                 tp = trig_actions;
                 trig_actions = trig_actions->next;
+                t_set.erase(tp->stmt);
             } while (trig_actions && trig_actions->stmt);
             tp->next = 0;
 
@@ -1680,6 +1900,7 @@ vl_timeslot::do_actions(vl_simulator *sim)
             // by the previous actions
             a = trig_actions;
             trig_actions = 0;
+            t_set.clear();
             doing_trig = true;
             trig_sp = 0;
         }
@@ -1770,11 +1991,13 @@ vl_timeslot::do_actions(vl_simulator *sim)
                 acts[sp].type = ntype;
                 acts[sp].fjblk = (ntype == Fork ? a->stmt : 0);
                 actions = 0;
+                a_set.clear();
             }
             else {
                 a_end->next = acts[sp].actions;
                 acts[sp].actions = actions;
                 actions = 0;
+                a_set.clear();
             }
         }
 
@@ -1889,32 +2112,101 @@ vl_timeslot::purge(vl_stmt *blk)
     for (vl_timeslot *ts = this; ts; ts = ts->next) {
         ts->actions = ts->actions->purge(blk);
         ts->a_end = ts->actions;
+        ts->a_set.clear();
         if (ts->a_end) {
-            while (ts->a_end->next)
+            ts->a_set.insert(ts->a_end->stmt);
+            while (ts->a_end->next) {
                 ts->a_end = ts->a_end->next;
+                ts->a_set.insert(ts->a_end->stmt);
+            }
         }
         ts->zdly_actions = ts->zdly_actions->purge(blk);
         ts->z_end = ts->zdly_actions;
+        ts->z_set.clear();
         if (ts->z_end) {
-            while (ts->z_end->next)
+            ts->z_set.insert(ts->z_end->stmt);
+            while (ts->z_end->next) {
                 ts->z_end = ts->z_end->next;
+                ts->z_set.insert(ts->z_end->stmt);
+            }
         }
         ts->nbau_actions = ts->nbau_actions->purge(blk);
         ts->n_end = ts->nbau_actions;
+        ts->n_set.clear();
         if (ts->n_end) {
-            while (ts->n_end->next)
+            ts->n_set.insert(ts->n_end->stmt);
+            while (ts->n_end->next) {
                 ts->n_end = ts->n_end->next;
+                ts->n_set.insert(ts->n_end->stmt);
+            }
         }
         ts->mon_actions = ts->mon_actions->purge(blk);
         ts->m_end = ts->mon_actions;
+        ts->m_set.clear();
         if (ts->m_end) {
-            while (ts->m_end->next)
+            ts->m_set.insert(ts->m_end->stmt);
+            while (ts->m_end->next) {
                 ts->m_end = ts->m_end->next;
+                ts->m_set.insert(ts->m_end->stmt);
+            }
         }
     }
 }
 
 
+// Exchange the active actions list with that of ts.  This is used to
+// set aside the pending actions while evaluating a function.
+//
+void
+vl_timeslot::swap_actions(vl_timeslot *ts)
+{
+    vl_action_item *a = actions;
+    actions = ts->actions;
+    ts->actions = a;
+    a = a_end;
+    a_end = ts->a_end;
+    ts->a_end = a;
+    a_set.swap(&ts->a_set);
+}
+
+
+// Exchange all action lists with those of ts.
+//
+void
+vl_timeslot::swap_contents(vl_timeslot *ts)
+{
+    swap_actions(ts);
+    vl_action_item *a = trig_actions;
+    trig_actions = ts->trig_actions;
+    ts->trig_actions = a;
+    a = t_end;
+    t_end = ts->t_end;
+    ts->t_end = a;
+    t_set.swap(&ts->t_set);
+    a = zdly_actions;
+    zdly_actions = ts->zdly_actions;
+    ts->zdly_actions = a;
+    a = z_end;
+    z_end = ts->z_end;
+    ts->z_end = a;
+    z_set.swap(&ts->z_set);
+    a = nbau_actions;
+    nbau_actions = ts->nbau_actions;
+    ts->nbau_actions = a;
+    a = n_end;
+    n_end = ts->n_end;
+    ts->n_end = a;
+    n_set.swap(&ts->n_set);
+    a = mon_actions;
+    mon_actions = ts->mon_actions;
+    ts->mon_actions = a;
+    a = m_end;
+    m_end = ts->m_end;
+    ts->m_end = a;
+    m_set.swap(&ts->m_set);
+}
+
+
 // Diagnostic printout for current time slot
 //
 void
@@ -2570,8 +2862,8 @@ vl_function::eval_func(vl_var *out, lsList<vl_expr*> *args)
     }
 
     vl_simulator *sim = outvar->simulator;
-    vl_action_item *atmp = sim->timewheel->actions;
-    sim->timewheel->actions = 0;
+    vl_timeslot tsave(sim->time);
+    sim->timewheel->swap_actions(&tsave);
 
     sim->context = sim->context->push(this);
     vl_setup_list(sim, decls);
@@ -2624,7 +2916,7 @@ vl_function::eval_func(vl_var *out, lsList<vl_expr*> *args)
         vl_setup_list(sim, stmts);
     while (sim->timewheel->actions)
         sim->timewheel->do_actions(sim);
-    sim->timewheel->actions = atmp;
+    sim->timewheel->swap_actions(&tsave);
     sim->context = sim->context->pop();
     *out = *outvar;
 }
@@ -952,6 +952,60 @@ struct vl_stack
     int num;  // depth of stack
 };
 
+// Counted set of statement pointers, used by vl_timeslot to suppress
+// duplicate actions without rescanning the action lists.  Clearing is
+// O(1), entries from an earlier epoch are treated as empty.
+//
+struct vl_stmt_set
+{
+    vl_stmt_set() { entries = 0; size = 0; used = 0; epoch = 1; }
+    ~vl_stmt_set() { delete [] entries; }
+
+    bool contains(vl_stmt *st) { return (st && find(st)); }
+    void insert(vl_stmt*);
+    void erase(vl_stmt*);
+    void clear();
+    void swap(vl_stmt_set*);
+
+private:
+    struct ss_ent
+    {
+        vl_stmt *stmt;
+        unsigned int count;
+        unsigned int epoch;
+    };
+
+    ss_ent *find(vl_stmt*);
+    void rehash(unsigned int);
+
+    ss_ent *entries;
+    unsigned int size;      // table size, power of 2
+    unsigned int used;      // live and erased entries in current epoch
+    unsigned int epoch;
+};
+
+// Time-sorted index of the timeslot list, shared by all slots in the
+// list, provides a binary search in place of a list walk when
+// scheduling.  Slots are retired from the front, so the array keeps
+// a movable start offset.
+//
+struct vl_tsindex
+{
+    vl_tsindex() { slots = 0; size = 0; start = 0; num = 0; }
+    ~vl_tsindex() { delete [] slots; }
+
+    vl_timeslot *slot(int i) { return (slots[start + i]); }
+    void set_slot(int i, vl_timeslot *ts) { slots[start + i] = ts; }
+    int find(vl_time_t, bool*);
+    void insert(int, vl_timeslot*);
+    void remove(vl_timeslot*);
+
+    vl_timeslot **slots;
+    int size;
+    int start;
+    int num;
+};
+
 // List head for actions at a time point
 //
 struct vl_timeslot
@@ -978,6 +1032,7 @@ struct vl_timeslot
     void add_next_actions(vl_simulator*);
     void do_actions(vl_simulator*);
     void purge(vl_stmt*);
+    void swap_actions(vl_timeslot*);
     void print(ostream&);
 
     vl_time_t time;
@@ -993,6 +1048,16 @@ private:
     vl_action_item *z_end;			// end of zdly_actions list
     vl_action_item *n_end;			// end of nbau_actions list
     vl_action_item *m_end;			// end of mon_actions list
+    vl_stmt_set a_set;              // statements in actions list
+    vl_stmt_set t_set;              // statements in trig_actions list
+    vl_stmt_set z_set;              // statements in zdly_actions list
+    vl_stmt_set n_set;              // statements in nbau_actions list
+    vl_stmt_set m_set;              // statements in mon_actions list
+    vl_tsindex *index;              // time index, shared by list
+
+    void append_list(vl_action_item**, vl_action_item**, vl_stmt_set*,
+        vl_action_item*);
+    void swap_contents(vl_timeslot*);
 };
 
 // List multiple 'top' modules
@@ -317,7 +317,7 @@ BJTdev::BJTdev()
     dv_numModelParms = NUMELEMS(BJTmPTable);
     dv_modelParms = BJTmPTable;
 
-    dv_flags = DV_TRUNC;
+    dv_flags = DV_TRUNC | DV_BYPASS;
 };
 
 
@@ -2142,7 +2142,7 @@ BSIM4dev::BSIM4dev()
     dv_numModelParms = NUMELEMS(BSIM4mPTable);
     dv_modelParms = BSIM4mPTable;
 
-    dv_flags = DV_TRUNC | DV_NODIST;
+    dv_flags = DV_TRUNC | DV_NODIST | DV_BYPASS;
 };
 
 
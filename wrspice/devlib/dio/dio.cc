@@ -226,7 +226,7 @@ DIOdev::DIOdev()
     dv_numModelParms = NUMELEMS(DIOmPTable);
     dv_modelParms = DIOmPTable;
 
-    dv_flags = DV_TRUNC | DV_NOLEVCHG;
+    dv_flags = DV_TRUNC | DV_NOLEVCHG | DV_BYPASS;
 };
 
 
@@ -194,7 +194,7 @@ JFETdev::JFETdev()
     dv_numModelParms = NUMELEMS(JFETmPTable);
     dv_modelParms = JFETmPTable;
 
-    dv_flags = DV_TRUNC;
+    dv_flags = DV_TRUNC | DV_BYPASS;
 };
 
 
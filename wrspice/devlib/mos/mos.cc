@@ -344,7 +344,7 @@ MOSdev::MOSdev()
     dv_numModelParms = NUMELEMS(MOSmPTable);
     dv_modelParms = MOSmPTable;
 
-    dv_flags = DV_TRUNC | DV_NOLEVCHG;
+    dv_flags = DV_TRUNC | DV_NOLEVCHG | DV_BYPASS;
 };
 
 
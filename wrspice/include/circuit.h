@@ -82,6 +82,8 @@ struct VerilogBlock;
 struct sJOB;
 struct sTASK;
 struct sCKT;
+struct sCKTbypass;
+struct IFdevice;
 struct sFtCirc;
 struct sHtab;
 struct IFmacro;
@@ -171,6 +173,7 @@ struct sGENinstance
     sGENinstance *GENnextInstance;      // pointer to next instance of 
     sGENinstance *GENnextTabInstance;   // hash table link
                                         //  current model
+    sCKTbypass *GENbypass;              // load bypass record, or null
     IFuid GENname;      // pointer to character string naming this instance
     int GENstate;       // state index number
     int GENnumNodes;    // max node count
@@ -338,13 +341,17 @@ struct sACprms
     int query(int, IFdata*) const;
     int setp(int, IFdata*);
     int points(const sCKT*);
-    int loop(LoopWorkFunc, sCKT*, int);
+    int loop(LoopWorkFunc, sCKT*, int, bool = false);
 
     double fstart()         { return (ac_fstart); }
     double fstop()          { return (ac_fstop); }
     AC_STEPTYPE stepType()  { return (ac_stepType); }
 
 private:
+#ifdef WITH_THREADS
+    int loop_mt(LoopWorkFunc, sCKT*, double, double);
+#endif
+
     double ac_fstart;
     double ac_fstop;
     double ac_fsave;
@@ -620,6 +627,11 @@ enum OMRG_TYPE { OMRG_GLOBAL, OMRG_LOCAL, OMRG_NOSHELL };
 #define DEF_gminFirst           false
 #define DEF_hspice              false
 #define DEF_jjaccel             false
+#define DEF_loadBypass          false
+#ifdef WITH_THREADS
+#define DEF_loadBufs            false
+#endif
+#define DEF_noExprTape          false
 #define DEF_noiter              false
 #define DEF_nojjtp              false
 #define DEF_noKLU               false
@@ -698,6 +710,11 @@ struct sOPTIONS : public sJOB
             OPTgminfirst    = DEF_gminFirst;
             OPThspice       = DEF_hspice;
             OPTjjaccel      = DEF_jjaccel;
+            OPTloadbypass   = DEF_loadBypass;
+#ifdef WITH_THREADS
+            OPTloadbufs     = DEF_loadBufs;
+#endif
+            OPTnoexprtape   = DEF_noExprTape;
             OPTnoiter       = DEF_noiter;
             OPTnojjtp       = DEF_nojjtp;
             OPTnoklu        = DEF_noKLU;
@@ -766,6 +783,11 @@ struct sOPTIONS : public sJOB
             OPTgminfirst_given      = 0;
             OPThspice_given         = 0;
             OPTjjaccel_given        = 0;
+            OPTloadbypass_given     = 0;
+#ifdef WITH_THREADS
+            OPTloadbufs_given       = 0;
+#endif
+            OPTnoexprtape_given     = 0;
             OPTnoiter_given         = 0;
             OPTnojjtp_given         = 0;
             OPTnoklu_given          = 0;
@@ -845,6 +867,11 @@ struct sOPTIONS : public sJOB
     bool OPTgminfirst;
     bool OPThspice;
     bool OPTjjaccel;
+    bool OPTloadbypass;
+#ifdef WITH_THREADS
+    bool OPTloadbufs;
+#endif
+    bool OPTnoexprtape;
     bool OPTnoiter;
     bool OPTnojjtp;
     bool OPTnoklu;
@@ -913,6 +940,11 @@ struct sOPTIONS : public sJOB
     unsigned int OPTgminfirst_given:1;
     unsigned int OPThspice_given:1;
     unsigned int OPTjjaccel_given:1;
+    unsigned int OPTloadbypass_given:1;
+#ifdef WITH_THREADS
+    unsigned int OPTloadbufs_given:1;
+#endif
+    unsigned int OPTnoexprtape_given:1;
     unsigned int OPTnoiter_given:1;
     unsigned int OPTnojjtp_given:1;
     unsigned int OPTnoklu_given:1;
@@ -1018,6 +1050,11 @@ struct sTASK : public cBase
 #define TSKgminFirst        TSKopts.OPTgminfirst
 #define TSKhspice           TSKopts.OPThspice
 #define TSKjjaccel          TSKopts.OPTjjaccel
+#define TSKloadBypass       TSKopts.OPTloadbypass
+#ifdef WITH_THREADS
+#define TSKloadBufs         TSKopts.OPTloadbufs
+#endif
+#define TSKnoExprTape       TSKopts.OPTnoexprtape
 #define TSKnoiter           TSKopts.OPTnoiter
 #define TSKnojjtp           TSKopts.OPTnojjtp
 #define TSKnoKLU            TSKopts.OPTnoklu
@@ -1091,9 +1128,13 @@ struct sSTATS
             STATmatSize = 0;
             STATnonZero = 0;
             STATfillIn = 0;
+            STATloadEvals = 0;
+            STATloadBypassed = 0;
 #ifdef WITH_THREADS
             STATloadThreads = 0;
             STATloopThreads = 0;
+            STATloadBufs = 0;
+            STATloadBufTime = 0.0;
 #endif
             STATpageFaults = 0;
             STATvolCxSwitch = 0;
@@ -1125,9 +1166,13 @@ struct sSTATS
     int STATmatSize;        // matrix size
     int STATnonZero;        // number of nonzero entries
     int STATfillIn;         // number of fill-in terms added in reorder
+    int STATloadEvals;      // instance loads evaluated, with loadbypass
+    int STATloadBypassed;   // instance loads bypassed, with loadbypass
 #ifdef WITH_THREADS
     int STATloadThreads;    // number of loading helper threads
     int STATloopThreads;    // number of looping helper threads
+    int STATloadBufs;       // number of private stamp buffers in use
+    double STATloadBufTime; // time spent summing stamp buffers into matrix
 #endif
     int STATpageFaults;     // page faults during analysis
     int STATvolCxSwitch;    // voluntary context switches during analysis
@@ -1232,6 +1277,64 @@ private:
     unsigned int        ix;
 };
 
+// A flat index of the device instances, built at setup time.  The
+// instance pointers are kept in one contiguous array, ordered by
+// device type and then by model, and each model owns a span of the
+// array.  The load function and the thread batching iterate over
+// this rather than following the model and instance lists, which is
+// much kinder to the cache in large circuits.
+
+struct sCKTinstSpan
+{
+    sGENmodel *model;       // the model
+    IFdevice *dev;          // device for the model type
+    unsigned int start;     // offset of first instance
+    unsigned int count;     // number of instances
+};
+
+struct sCKTinstTab
+{
+    sCKTinstTab()
+        {
+            it_insts = 0;
+            it_spans = 0;
+            it_numInsts = 0;
+            it_instSize = 0;
+            it_numSpans = 0;
+            it_spanSize = 0;
+            it_valid = false;
+        }
+
+    ~sCKTinstTab()
+        {
+            delete [] it_insts;
+            delete [] it_spans;
+        }
+
+    void build(const sCKTmodHead&);
+
+    // Call when instances or models are added or removed, the index
+    // will be rebuilt before next use.
+    void invalidate()                   { it_valid = false; }
+
+    bool valid()                  const { return (it_valid); }
+    unsigned int numInsts()       const { return (it_numInsts); }
+    unsigned int numSpans()       const { return (it_numSpans); }
+    const sCKTinstSpan *span(unsigned int i) const
+                                        { return (it_spans + i); }
+    sGENinstance **insts(const sCKTinstSpan *s) const
+                                        { return (it_insts + s->start); }
+
+private:
+    sGENinstance    **it_insts;
+    sCKTinstSpan    *it_spans;
+    unsigned int    it_numInsts;
+    unsigned int    it_instSize;
+    unsigned int    it_numSpans;
+    unsigned int    it_spanSize;
+    bool            it_valid;
+};
+
 // Breakpoint control.
 //
 struct sCKTlattice
@@ -1515,6 +1618,129 @@ enum UID_TYPE {
     UID_OTHER    = 0x10
 };
 
+// Private matrix/rhs stamp buffer, used when multi-threaded loading
+// with the loadbufs option set.  Each load batch has its own buffer,
+// so the worker threads record contributions here without atomics or
+// locks.  After all workers are done, the main thread sums the
+// buffers into the matrix and rhs, in batch order, so that results
+// are reproducible for a given thread count.  This is also used to
+// capture the contributions of a single instance for load bypass.
+//
+struct sCKTstampBuf
+{
+    struct sMent
+    {
+        double *ptr;
+        double val;
+    };
+
+    struct sRent
+    {
+        int ix;
+        double val;
+    };
+
+    sCKTstampBuf()
+        {
+            sb_mat = 0;
+            sb_rhs = 0;
+            sb_nmat = 0;
+            sb_nrhs = 0;
+            sb_msize = 0;
+            sb_rsize = 0;
+        }
+
+    ~sCKTstampBuf()
+        {
+            delete [] sb_mat;
+            delete [] sb_rhs;
+        }
+
+    void ldadd(double *ptr, double val)
+        {
+            if (sb_nmat == sb_msize)
+                grow_mat();
+            sb_mat[sb_nmat].ptr = ptr;
+            sb_mat[sb_nmat].val = val;
+            sb_nmat++;
+        }
+
+    void rhsadd(int ix, double val)
+        {
+            if (sb_nrhs == sb_rsize)
+                grow_rhs();
+            sb_rhs[sb_nrhs].ix = ix;
+            sb_rhs[sb_nrhs].val = val;
+            sb_nrhs++;
+        }
+
+    void reset()
+        {
+            sb_nmat = 0;
+            sb_nrhs = 0;
+        }
+
+    unsigned int count()    const { return (sb_nmat + sb_nrhs); }
+    unsigned int num_rhs()  const { return (sb_nrhs); }
+    int rhs_index(unsigned int i) const { return (sb_rhs[i].ix); }
+
+    // ckt.cc
+    void reduce(double*, bool) const;
+    void replay(sCKT*) const;
+    void compact();
+
+private:
+    void grow_mat();
+    void grow_rhs();
+
+    sMent *sb_mat;              // matrix contributions
+    sRent *sb_rhs;              // rhs contributions
+    unsigned int sb_nmat;       // matrix entries used
+    unsigned int sb_nrhs;       // rhs entries used
+    unsigned int sb_msize;      // matrix entries allocated
+    unsigned int sb_rsize;      // rhs entries allocated
+};
+
+// Per-instance record for load bypass, used with the loadbypass
+// option.  This saves the matrix and rhs contributions from the most
+// recent evaluation of the instance, and the node voltages used.  If
+// the voltages have not changed significantly in a later iteration
+// of the same load context (epoch), the saved contributions are added
+// to the matrix in place of calling the device load function.
+//
+struct sCKTbypass
+{
+    sCKTbypass()
+        {
+            bp_next = 0;
+            bp_inst = 0;
+            bp_nodes = 0;
+            bp_volts = 0;
+            bp_nnodes = 0;
+            bp_nsize = 0;
+            bp_epoch = 0;
+        }
+
+    ~sCKTbypass()
+        {
+            delete [] bp_nodes;
+            delete [] bp_volts;
+        }
+
+    // ckt.cc
+    bool quiet(const double*, double, double) const;
+    void save_volts(sGENinstance*, const double*);
+
+    sCKTbypass *bp_next;        // list link, records owned by sCKT
+    sGENinstance *bp_inst;      // instance using this record
+    sCKTstampBuf bp_stamps;     // saved contributions
+    int *bp_nodes;              // nodes watched
+    double *bp_volts;           // voltages used in evaluation
+    unsigned int bp_nnodes;     // nodes in use in node and voltage arrays
+    unsigned int bp_nsize;      // allocated size of node and voltage arrays
+    unsigned int bp_epoch;      // epoch of evaluation, 0 if invalid
+};
+
 // The circuit control struct
 //
 struct sCKT
@@ -1545,6 +1771,9 @@ struct sCKT
     int ic();
     int inst2Node(sGENinstance*, int, sCKTnode**, IFuid*) const;
     int load(bool = false);
+    int loadBypass(IFdevice*, sGENinstance*, int*);
+    sCKTbypass *newBypass();
+    void addLoadCounts(int, int);
     int loadGmin();
     double computeMinDelta();
     int backup(DEV_BKMODE);
@@ -1679,7 +1908,12 @@ public:
 #ifdef WITH_THREADS
     void ldadd(double *ptr, double val)
         {
-            if (!CKTloadThreads) {
+            if (CKTstampBuf) {
+                // Private buffer, summed into the matrix after all
+                // threads finish, or captured for load bypass.
+                CKTstampBuf->ldadd(ptr, val);
+            }
+            else if (!CKTloadThreads) {
                 if (CKTextPrec)
                     *(long double*)ptr += val;
                 else
@@ -1720,7 +1954,9 @@ public:
 #else
     void ldadd(double *ptr, double val)
         {
-            if (CKTextPrec)
+            if (CKTstampBuf)
+                CKTstampBuf->ldadd(ptr, val);
+            else if (CKTextPrec)
                 *(long double*)ptr += val;
             else
                 *ptr += val;
@@ -1738,7 +1974,9 @@ public:
 #ifdef WITH_THREADS
     void rhsadd(int o, double val)
         {
-            if (!CKTloadThreads)
+            if (CKTstampBuf)
+                CKTstampBuf->rhsadd(o, val);
+            else if (!CKTloadThreads)
                 *(CKTrhs + o) += val;
             else {
 #ifdef WITH_ATOMIC
@@ -1760,7 +1998,10 @@ public:
 #else
     void rhsadd(int o, double val)
         {
-            *(CKTrhs + o) += val;
+            if (CKTstampBuf)
+                CKTstampBuf->rhsadd(o, val);
+            else
+                *(CKTrhs + o) += val;
         }
 #endif
 
@@ -1996,6 +2237,7 @@ public:
     double *CKToldState0;   // known-good state0 backup
 
     sCKTmodHead CKTmodels;  // list of device models
+    sCKTinstTab CKTinstTab; // flat index of instances, for loading
     sFtCirc *CKTbackPtr;    // backpointer to container
     sCKTtable *CKTtableHead; // head of table list
     sSTATS *CKTstat;        // STATistics
@@ -2004,6 +2246,10 @@ public:
     double *CKTtemps;       // list of temperatures from .TEMP
 
     cThreadPool *CKTloadPool; // multi-thread load pool
+#ifdef WITH_THREADS
+    sCKTstampBuf *CKTstampBufs; // per-batch stamp buffers, or null
+#endif
+    sCKTbypass *CKTbypassList; // load bypass records
     sTASK *CKTcurTask;      // pointer to current task
     sJOB *CKTcurJob;        // pointer to current job
     spMatrixFrame *CKTmatrix; // pointer to sparse matrix
@@ -2026,8 +2272,10 @@ public:
     int CKTextPrec;
 #ifdef WITH_THREADS
     int CKTloadThreads;     // number of loading threads in use
+    int CKTnumStampBufs;    // size of CKTstampBufs array
     int CKTthreadId;        // thread index, 0 is main thread
 #endif
+    unsigned int CKTbypassEpoch; // load context counter for bypass
     int CKTnumDC;           // number of DC calls to analysis (chained DC)
     int CKTcntDC;           // analysis calls thus far
 
@@ -2043,6 +2291,20 @@ public:
     bool CKTtrapBad;        // check found non-convergence
     bool CKTneedsRevertResetup;  // need to call resetup after dev restore
     bool CKTnogo;           // error found, circuit bad
+    bool CKTbypassOn;       // load bypass active in this load
+
+    // Load context when CKTbypassEpoch was last advanced.
+    struct sCKTbypassCtx
+    {
+        double ag[7];
+        double time;
+        double delta;
+        double srcfact;
+        double diaggmin;
+        double gmin;
+        int mode;
+        int order;
+    } CKTbypassCtx;
 
     double CKTbreaks[2];          // breakpoint table
     sCKTlattice CKTlattice;       // breakpoint control
@@ -2078,6 +2340,14 @@ public:
 #ifndef THREAD_SAFE_EVAL
     static pthread_mutex_t CKTloadLock4;
 #endif
+    // Serializes output from threads writing to a shared plot.
+    static pthread_mutex_t CKTdumpLock;
+    // The stamp buffer in use by the calling thread, set only while
+    // loading through the thread pool with the loadbufs option, or
+    // when capturing for load bypass.
+    static __thread sCKTstampBuf *CKTstampBuf;
+#else
+    static sCKTstampBuf *CKTstampBuf;
 #endif
 };
 
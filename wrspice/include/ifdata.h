@@ -159,6 +159,8 @@ struct sArgMap;
 // This structure is returned by the parser for a IF_PARSETREE valued
 // parameter.
 //
+struct PTtape;
+
 struct IFparseTree
 {
     // Allocation block of IFparseNode structs.
@@ -183,6 +185,7 @@ struct IFparseTree
     bool differentiate();
     bool isConst();
     int eval(double*, double*, double*, int* = 0);
+    int evalTree(double*, double*, double*, int*);
     void print(const char*);
     void varName(int, sLstr&);
     int initTranFuncs(double, double);
@@ -231,6 +234,7 @@ private:
     IFdata *pt_vars;            // Array of structures describing values.
     char *pt_xalias;            // Token to replace "x".
     IFparseNode *pt_xtree;      // Parse tree for "x".
+    PTtape *pt_tape;            // Compiled tape for evaluation, or null.
     int pt_num_vars;            // Number of variables used.
     int pt_num_xvars;           // Number of variables referenced for "x".
     sArgMap *pt_argmap;         // Temporary argument mapping for macros,
@@ -244,6 +248,7 @@ private:
     int pt_pn_size;             // Size of current block;
 
     bool pt_error;              // A parse or setup error occurred.
+    bool pt_notape;             // Tape compile failed, use the tree.
     bool pt_macro;
     // Set when parsing a macro.  In this case we skip the test for
     // placeholder nodes (which become macro arguments).
@@ -551,6 +556,7 @@ enum DEV_BKMODE { DEV_CLEAR, DEV_SAVE, DEV_RESTORE };
 #define DV_NONOIS   0x200   // no NOISE analysis with this device
 #define DV_NOPZ     0x400   // no PZ analysis with this device
 #define DV_NODIST   0x800   // no DISTO analysis with this device
+#define DV_BYPASS   0x1000  // load contributions can be saved and reused
 
 // structure:  IFdevice
 //
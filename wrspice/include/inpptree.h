@@ -123,6 +123,7 @@ enum PTfType
 
 struct IFparseTree;
 struct IFparseNode;
+struct PTtape;
 struct IFmacro;
 struct IFmacroDeriv;
 struct sLstr;
@@ -139,6 +140,8 @@ struct IFparseNode
 {
     friend struct PTelement;
     friend struct IFparseTree;
+    friend struct PTtape;
+    friend struct PTtapeBld;
     friend struct IFmacro;
     friend struct sCKT;
 #define NEWTF
@@ -333,6 +336,83 @@ private:
 };
 
 
+// Operations for the compiled expression tape.
+//
+enum PTiType
+{
+    PTI_CONST,          // load constant
+    PTI_VAR,            // load circuit variable
+    PTI_PLUS,           // add two registers
+    PTI_MINUS,          // subtract two registers
+    PTI_TIMES,          // multiply two registers
+    PTI_UMINUS,         // negate register
+    PTI_FUNC1,          // call node function with one register
+    PTI_FUNC2,          // call node function with two registers
+    PTI_NODE            // evaluate node with its evaluation function
+};
+
+// An instruction for the tape.  Each instruction writes the register
+// with the same index as the instruction, operands are registers
+// with smaller indices.
+//
+struct PTinstr
+{
+    unsigned char op;           // PTiType
+    short int fidx;             // PTF_* or PT_* for CSE matching
+    int a;                      // first operand register
+    int b;                      // second operand register
+    union {
+        double constant;        // if PTI_CONST
+        int index;              // if PTI_VAR
+        IFparseNode *node;      // if PTI_FUNC1, PTI_FUNC2, PTI_NODE
+    } u;
+};
+
+// Structure:   PTtape
+//
+// A parse tree and its derivative trees, compiled into a linear list
+// of instructions.  Common subexpressions are evaluated once, and
+// constant subexpressions are folded.  Nodes that aren't simple
+// arithmetic (tran functions, tables, macros, device parameters) are
+// evaluated through their tree evaluation functions.
+//
+struct PTtape
+{
+    PTtape()
+        {
+            t_instrs = 0;
+            t_outputs = 0;
+            t_ninstrs = 0;
+            t_nval = 0;
+            t_noutputs = 0;
+        }
+
+    ~PTtape()
+        {
+            delete [] t_instrs;
+            delete [] t_outputs;
+        }
+
+    // inpptape.cc
+    static PTtape *compile(IFparseNode*, IFparseNode**, int);
+    int eval(double*, double*, const double*) const;
+
+    bool has_derivs()           const { return (t_noutputs > 1); }
+
+    static double call(IFparseNode *p, const double *args)
+        {
+            return ((p->*p->p_func)(args));
+        }
+
+private:
+    PTinstr *t_instrs;          // instruction list
+    int *t_outputs;             // result registers, value then derivs
+    int t_ninstrs;              // number of instructions
+    int t_nval;                 // instructions needed for value only
+    int t_noutputs;             // 1 + number of derivatives compiled
+};
+
+
 // The parser stack element.
 //
 struct PTelement : public Element
@@ -167,6 +167,9 @@ extern const char *spkw_forcegmin;
 extern const char *spkw_gminfirst;
 extern const char *spkw_hspice;
 extern const char *spkw_jjaccel;
+extern const char *spkw_loadbypass;
+extern const char *spkw_loadbufs;
+extern const char *spkw_noexprtape;
 extern const char *spkw_noiter;
 extern const char *spkw_nojjtp;
 extern const char *spkw_noklu;
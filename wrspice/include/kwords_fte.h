@@ -214,6 +214,7 @@ extern const char *kw_degrees;
 // the command configuration keywords
 extern const char *kw_appendwrite;
 extern const char *kw_checkiterate;
+extern const char *kw_checkjobs;
 extern const char *kw_diff_abstol;
 extern const char *kw_diff_reltol;
 extern const char *kw_diff_vntol;
@@ -104,6 +104,11 @@ enum OPTtype
     OPT_GMINFIRST,
     OPT_HSPICE,
     OPT_JJACCEL,
+    OPT_LOADBYPASS,
+#ifdef WITH_THREADS
+    OPT_LOADBUFS,
+#endif
+    OPT_NOEXPRTAPE,
     OPT_NOITER,
     OPT_NOJJTP,
     OPT_NOKLU,
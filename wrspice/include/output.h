@@ -448,6 +448,7 @@ struct IFoutput
     sRunDesc *beginPlot(sOUTdata*, int = 0, const char* = 0, double = 0.0);
     int appendData(sRunDesc*, IFvalue*, IFvalue*);
     int insertData(sCKT*, sRunDesc*, IFvalue*, IFvalue*, unsigned int);
+    bool canInsert(sRunDesc*);
     int setDims(sRunDesc*, int*, int, bool = false);
     int setDC(sRunDesc*, sDCTprms*);
     int setAttrs(sRunDesc*, IFuid*, OUTscaleType, IFvalue*);
@@ -48,6 +48,9 @@
 // Read and write the ascii and binary rawfile formats.
 //
 
+// Size in doubles of the binary output buffer.
+#define RAW_BUFSIZE 32768
+
 class cRawOut : public cFileOut
 {
 public:
@@ -60,6 +63,7 @@ public:
     bool file_open(const char*, const char*, bool);
     void file_set_fp(FILE *fp)
         {
+            flush_buf();
             ro_fp = fp;
             ro_no_close = true;
         }
@@ -70,8 +74,21 @@ public:
     bool file_close();
 
 private:
+    // Binary data are staged here and written in blocks, rather than
+    // with a write call per value.
+    void put_val(double d)
+        {
+            if (ro_bufcnt == RAW_BUFSIZE)
+                flush_buf();
+            ro_buf[ro_bufcnt++] = d;
+        }
+
+    bool flush_buf();
+
     sPlot *ro_plot;
     FILE *ro_fp;
+    double *ro_buf;
+    unsigned int ro_bufcnt;
     long ro_pointPosn;
     int ro_prec;
     int ro_numdims;
@@ -94,6 +111,7 @@ public:
 
 private:
     void read_data(bool, sPlot*);
+    int read_mapped(sPlot*, int);
 
     static void add_point(sDataVec*, double*, double*);
     static void fixdims(sDataVec*, const char*);
@@ -55,6 +55,7 @@ Authors: 1985 Wayne A. Christopher
 //
 
 struct sRunDesc;
+struct sDataVec;
 struct pnode;
 
 enum ROtype
@@ -266,6 +267,28 @@ enum MPrange
     MPafter         // appies after defined value
 };
 
+// Scale context for trigger detection at the current point.  This is
+// taken from the run plot scale vector, or when streaming is tracked
+// by the measurement, as the plot keeps only the current point.
+//
+struct sMscale
+{
+    sMscale()
+        {
+            x       = 0.0;
+            xprev   = 0.0;
+            xfirst  = 0.0;
+            indx    = 0;
+        }
+
+    void set(sDataVec*);
+
+    double x;               // Current scale value.
+    double xprev;           // Previous scale value.
+    double xfirst;          // First scale value.
+    int indx;               // Index of current point.
+};
+
 struct sMpoint
 {
     sMpoint()
@@ -331,10 +354,10 @@ struct sMpoint
 
     int parse(const char**, char**, const char*);
     void print(sLstr&);
-    bool check_found(sFtCirc*, bool*, bool, sMpoint* = 0);
+    bool check_found(sFtCirc*, bool*, bool, const sMscale&, sMpoint* = 0);
 
 private:
-    int check_trig(sDataVec*);
+    int check_trig(const sMscale&);
     sDataVec *eval1();
     sDataVec *eval2();
 
@@ -382,9 +405,13 @@ struct sMfunc
             f_next  = 0;
             f_expr  = e;
             f_val   = 0.0;
+            f_tree  = 0;
+            f_xbuf  = 0;
+            f_ybuf  = 0;
+            reset();
         }
 
-    ~sMfunc()       { delete [] f_expr; }
+    ~sMfunc();
 
     static void destroy_list(sMfunc *f)
         {
@@ -405,12 +432,26 @@ struct sMfunc
     void set_val(double d)      { f_val = d; }
 
     void print(sLstr&);
+    void reset();
+    void stream_eval(int);
 
     Mfunc f_type;       // type of job
     bool f_error;       // set if expr evaluation fails
     sMfunc *f_next;     // pointer to next job
     const char *f_expr; // expression to evaluate
     double f_val;       // result of measurement
+
+    // Used when streaming only.
+    pnode *f_tree;      // expression parse tree
+    sDataVec *f_xbuf;   // interval scale values, pw and rft only
+    sDataVec *f_ybuf;   // interval values, pw and rft only
+    double f_y[3];      // values at the last three points
+    double f_ys;        // value at start index
+    double f_sv;        // interpolated value at start point
+    double f_min;       // running minimum over interval
+    double f_max;       // running maximum over interval
+    double f_sum;       // running trapezoid integral
+    double f_sum2;      // running trapezoid integral of square
 };
 
 
@@ -427,6 +468,13 @@ struct sRunopMeas : public sRunop
         ro_cktptr               = 0;
         ro_funcs                = 0;
         ro_finds                = 0;
+        ro_x[0]                 = 0.0;
+        ro_x[1]                 = 0.0;
+        ro_x[2]                 = 0.0;
+        ro_xfirst               = 0.0;
+        ro_xs                   = 0.0;
+        ro_npts                 = -1;
+        ro_ipt                  = -1;
         ro_analysis             = 0;
         ro_found_rises          = 0;
         ro_found_falls          = 0;
@@ -437,6 +485,7 @@ struct sRunopMeas : public sRunop
         ro_measure_skip         = false;
         ro_stop_flag            = false;
         ro_end_flag             = false;
+        ro_stream               = false;
         ro_print_flag           = 0;
 
         parse(str, errstr);
@@ -503,8 +552,12 @@ private:
     double endval(sDataVec*, sDataVec*);
     double findavg(sDataVec*, sDataVec*);
     double findrms(sDataVec*, sDataVec*);
-    double findpw(sDataVec*, sDataVec*);
-    double findrft(sDataVec*, sDataVec*);
+    double findpw(sDataVec*, sDataVec*, int, int, double, double);
+    double findrft(sDataVec*, sDataVec*, int, int, double, double);
+    void stream_point(sFtCirc*);
+    void stream_update();
+    bool stream_val(sMfunc*, int, double*);
+    bool stream_measure(sDataVec**, int*);
 
     sMpoint ro_start;
     sMpoint ro_end;
@@ -516,6 +569,11 @@ private:
     sFtCirc *ro_cktptr;         // back pointer to circuit
     sMfunc *ro_funcs;           // list of measurements over interval
     sMfunc *ro_finds;           // list of measurements at point
+    double ro_x[3];             // scale at last three points, streaming
+    double ro_xfirst;           // first scale value, streaming
+    double ro_xs;               // scale value at start index, streaming
+    int ro_npts;                // index of current point, streaming
+    int ro_ipt;                 // next point to accumulate, streaming
     int ro_analysis;            // type index of analysis 
     int ro_found_rises;         // number of rising crossings
     int ro_found_falls;         // number of falling crossings
@@ -526,6 +584,7 @@ private:
     bool ro_measure_skip;       // parse error so skip
     bool ro_stop_flag;          // pause analysis when done
     bool ro_end_flag;           // terminate analysis when done
+    bool ro_stream;             // plot keeps no history, measure as we go
     char ro_print_flag;         // print result on screen, 1 terse  2 verbose
 };
 
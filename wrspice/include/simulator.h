@@ -869,6 +869,10 @@ namespace ResPrint
 #define DEF_checkiterate_MIN    0
 #define DEF_checkiterate_MAX    10
 
+#define DEF_checkjobs           0
+#define DEF_checkjobs_MIN       0
+#define DEF_checkjobs_MAX       64
+
 #define DEF_diff_abstol         1e-12
 #define DEF_diff_abstol_MIN     1e-15
 #define DEF_diff_abstol_MAX     1e-9
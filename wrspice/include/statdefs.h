@@ -57,10 +57,14 @@ enum {
     ST_EQUATIONS,
     ST_FILLIN,
     ST_INVOLCXSWITCH,
+    ST_LOADBYPASSED,
+    ST_LOADEVALS,
     ST_LOADTIME,
 #ifdef WITH_THREADS
     ST_LOADTHRDS,
     ST_LOOPTHRDS,
+    ST_LOADBUFS,
+    ST_LOADBUFTIME,
 #endif
     ST_LUTIME,
     ST_MATSIZE,
@@ -107,7 +107,8 @@ ACanalysis::ac_dcoperation(sCKT *ckt, int restart)
         return (error);
 
     ckt->CKTniState |= NIACSHOULDREORDER;  // KLU requires this.
-    error = ((sACAN*)ckt->CKTcurJob)->JOBac.loop(ac_operation, ckt, restart);
+    error = ((sACAN*)ckt->CKTcurJob)->JOBac.loop(ac_operation, ckt, restart,
+        true);
     if (error)
         return (error);
 
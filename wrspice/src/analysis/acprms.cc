@@ -40,7 +40,12 @@
 
 #include "device.h"
 #include "output.h"
+#include "simulator.h"
 #include "sparse/spmatrix.h"
+#include "miscutil/lstring.h"
+#ifdef WITH_THREADS
+#include "miscutil/threadpool.h"
+#endif
 
 
 //
@@ -229,8 +234,12 @@ sACprms::points(const sCKT *ckt)
 }
 
 
+// If mtok is set, the work function uses only the circuit passed, so
+// that frequency points can be evaluated concurrently in circuit
+// copies when the loopthrds option is set.
+//
 int
-sACprms::loop(LoopWorkFunc func, sCKT *ckt, int restart)
+sACprms::loop(LoopWorkFunc func, sCKT *ckt, int restart, bool mtok)
 {
     double freqTol, freqDel;
     switch (ac_stepType) {
@@ -300,6 +309,22 @@ sACprms::loop(LoopWorkFunc func, sCKT *ckt, int restart)
     ckt->CKTinitFreq = ac_fstart * 2.0 * M_PI;
     ckt->CKTfinalFreq = ac_fstop * 2.0 * M_PI;
 
+#ifdef WITH_THREADS
+    // The frequency points are independent once the operating point
+    // is known, so they can be split between threads.  This is not
+    // done from a thread running a dc sweep point, which is already
+    // threaded, or when output goes directly to a file or to a
+    // margin analysis, as these need data in order.
+    if (mtok && restart && ckt->CKTcurTask->TSKloopThreads > 0 &&
+            ckt->CKTthreadId == 0) {
+        sJOB *job = ckt->CKTcurJob;
+        if (OP.canInsert(job->JOBrun) &&
+                job->JOBoutdata && job->JOBoutdata->cycle == 0 &&
+                points(ckt) > 1)
+            return (loop_mt(func, ckt, freqDel, freqTol));
+    }
+#endif
+
     int error;
     while (freq <= ac_fstop + freqTol) {
 
@@ -341,3 +366,237 @@ sACprms::loop(LoopWorkFunc func, sCKT *ckt, int restart)
     return (OK);
 }
 
+
+
+#ifdef WITH_THREADS
+
+namespace {
+    // Per-thread data.  Each helper thread has its own circuit
+    // object, the main thread uses the original circuit.
+    //
+    struct sACthCx : public sTPthreadData
+    {
+        sACthCx(sCKT *c, bool keepckt = false)
+            {
+                cx_ckt = c;
+                cx_keepckt = keepckt;
+            }
+
+        ~sACthCx()
+            {
+                if (!cx_keepckt)
+                    delete cx_ckt;
+            }
+
+        sCKT *ckt()         { return (cx_ckt); }
+
+    private:
+        sCKT *cx_ckt;
+        bool cx_keepckt;
+    };
+
+
+    // A job, which is a contiguous block of frequency points.
+    //
+    struct sACrun
+    {
+        sACrun(LoopWorkFunc f, const double *fr, int o, int n,
+            volatile int *a)
+            {
+                func = f;
+                freqs = fr;
+                offset = o;
+                count = n;
+                abort = a;
+            }
+
+        LoopWorkFunc func;
+        const double *freqs;
+        int offset;
+        int count;
+        volatile int *abort;    // Set nonzero to stop all jobs.
+    };
+
+
+    // The thread work procedure.  Between points, the main thread
+    // checks for an interrupt or pause request, which stops all
+    // jobs.  Jobs also stop if the output requests the end of the
+    // analysis, e.g., when the data size limit is reached.
+    //
+    int ac_thread_proc(sTPthreadData *data, void *arg)
+    {
+        sCKT *ckt = ((sACthCx*)data)->ckt();
+        sACrun *run = (sACrun*)arg;
+
+        // The output offset of a point is count, as there is a
+        // single cycle.
+        sOUTdata *outd = ckt->CKTcurJob->JOBoutdata;
+        outd->cycle = 1;
+        outd->count = run->offset;
+
+        for (int i = 0; i < run->count; i++) {
+            if (ckt->CKTthreadId == 0) {
+                int error = OP.pauseTest(ckt->CKTcurJob->JOBrun);
+                if (error < 0)
+                    *run->abort = error;
+            }
+            if (*run->abort || OP.endit())
+                return (0);
+            ckt->CKTomega = 2.0 * M_PI * run->freqs[run->offset + i];
+            ckt->CKTmode = MODEAC;
+            int error = (*run->func)(ckt, true);
+            if (error)
+                return (error);
+        }
+        return (0);
+    }
+
+
+    void ac_destroy_proc(void *arg)
+    {
+        delete (sACrun*)arg;
+    }
+
+
+    // Set up a thread circuit for small-signal analysis at the
+    // operating point of the main circuit.  The states and solution
+    // are copied, and the operating point is recomputed only if the
+    // circuits don't match.
+    //
+    int ac_thread_init(sCKT *tckt, sCKT *ckt)
+    {
+        int error = tckt->doTaskSetup();
+        if (error)
+            return (error);
+
+        int size = ckt->CKTmatrix->spGetSize(1);
+        if (tckt->CKTmatrix->spGetSize(1) == size &&
+                tckt->CKTnumStates == ckt->CKTnumStates) {
+            memcpy(tckt->CKTrhsOld, ckt->CKTrhsOld,
+                (size+1)*sizeof(double));
+            memcpy(tckt->CKTstates[0], ckt->CKTstates[0],
+                ckt->CKTnumStates*sizeof(double));
+        }
+        else {
+            error = tckt->ic();
+            if (error)
+                return (error);
+            error = tckt->op(MODEDCOP | MODEINITJCT, MODEDCOP | MODEINITFLOAT,
+                tckt->CKTcurTask->TSKdcMaxIter);
+            if (error)
+                return (error);
+        }
+        tckt->CKTmode = MODEDCOP | MODEINITSMSIG;
+        error = tckt->load();
+        if (error)
+            return (error);
+        tckt->CKTniState |= NIACSHOULDREORDER;
+        tckt->CKTinitFreq = ckt->CKTinitFreq;
+        tckt->CKTfinalFreq = ckt->CKTfinalFreq;
+        return (OK);
+    }
+}
+
+
+// Multi-threaded loop function.  The frequency list is split into
+// contiguous blocks, which are evaluated by the main thread and the
+// helpers, each with its own circuit and matrix.  The results are
+// written into the plot at the index of the frequency point.
+//
+// Points are not done in order, so the analysis can't be resumed
+// from where it stopped.  A pause request ends the analysis, as does
+// an interrupt.
+//
+int
+sACprms::loop_mt(LoopWorkFunc func, sCKT *ckt, double freqDel,
+    double freqTol)
+{
+    sJOB *job = ckt->CKTcurJob;
+
+    // Create the list of frequencies, as in the single-thread loop.
+    int npts = points(ckt);
+    double *freqs = new double[npts];
+    GCarray<double*> gc_freqs(freqs);
+    int nf = 0;
+    double freq = ac_fstart;
+    while (nf < npts && freq <= ac_fstop + freqTol) {
+        freqs[nf++] = freq;
+        if (ac_stepType == LINEAR) {
+            freq += freqDel;
+            if (freqDel == 0)
+                break;
+        }
+        else {
+            freq *= freqDel;
+            if (freqDel == 1)
+                break;
+        }
+    }
+
+    int nth = ckt->CKTcurTask->TSKloopThreads;  // number of threads
+    if (nth > nf-1)
+        nth = nf-1;
+    ckt->CKTstat->STATloopThreads = nth;
+
+    cThreadPool tp(nth);
+
+    for (int j = 0; j < nth; j++) {
+        sCKT *tckt;
+        int err = ckt->CKTbackPtr->newCKT(&tckt, 0);
+        if (err != OK)
+            return (err);
+        tckt->CKTthreadId = j+1;
+        tp.setThreadData(new sACthCx(tckt), j);
+
+        sTASK *ttsk = ckt->CKTcurTask->dup();
+        sJOB *tjob = job->dup();
+        if (!tjob) {
+            // Can't thread this analysis.
+            return (E_PANIC);
+        }
+        ttsk->TSKjobs = tjob;
+        tckt->CKTcurTask = ttsk;
+        tckt->CKTcurJob = tjob;
+
+        err = ac_thread_init(tckt, ckt);
+        if (err != OK)
+            return (err);
+    }
+
+    // Use a few blocks per thread, so that a thread that finishes
+    // early can pick up more work.
+    int nblk = 4*(nth + 1);
+    if (nblk > nf)
+        nblk = nf;
+    volatile int abort = 0;
+    int off = 0;
+    for (int i = 0; i < nblk; i++) {
+        int n = nf/nblk + (i < nf%nblk);
+        tp.submit(ac_thread_proc, new sACrun(func, freqs, off, n, &abort),
+            ac_destroy_proc);
+        off += n;
+    }
+
+    // Create a dummy context for the main thread, and run the pool.
+    sACthCx tcx(ckt, true);
+    int err = tp.run(&tcx);
+
+    // Done, restore the main thread circuit.
+    sOUTdata *outd = job->JOBoutdata;
+    outd->cycle = 0;
+    outd->count = nf;
+    if (err)
+        return (err);
+    if (abort)
+        return (E_INTRPT);
+    if (OP.endit()) {
+        OP.set_endit(false);
+        return (OK);
+    }
+
+    // The data are complete, check for measurements.
+    OP.checkRunops(job->JOBrun, freqs[nf-1]);
+    return (OK);
+}
+
+#endif
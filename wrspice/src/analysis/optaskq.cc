@@ -190,6 +190,17 @@ sOPTIONS::dump()
     askOpt(OPT_JJACCEL, &value, &notset);
     if (!notset)
         TTY.printf(ifmt, spkw_jjaccel, value.iValue);
+    askOpt(OPT_LOADBYPASS, &value, &notset);
+    if (!notset)
+        TTY.printf(ifmt, spkw_loadbypass, value.iValue);
+#ifdef WITH_THREADS
+    askOpt(OPT_LOADBUFS, &value, &notset);
+    if (!notset)
+        TTY.printf(ifmt, spkw_loadbufs, value.iValue);
+#endif
+    askOpt(OPT_NOEXPRTAPE, &value, &notset);
+    if (!notset)
+        TTY.printf(ifmt, spkw_noexprtape, value.iValue);
     askOpt(OPT_NOITER, &value, &notset);
     if (!notset)
         TTY.printf(ifmt, spkw_noiter, value.iValue);
@@ -517,6 +528,26 @@ sOPTIONS::askOpt(int which, IFvalue *value, int *notset)
         else
             *notset = 1;
         break;
+    case OPT_LOADBYPASS:
+        if (opt && OPTloadbypass_given)
+            value->iValue = OPTloadbypass;
+        else
+            *notset = 1;
+        break;
+#ifdef WITH_THREADS
+    case OPT_LOADBUFS:
+        if (opt && OPTloadbufs_given)
+            value->iValue = OPTloadbufs;
+        else
+            *notset = 1;
+        break;
+#endif
+    case OPT_NOEXPRTAPE:
+        if (opt && OPTnoexprtape_given)
+            value->iValue = OPTnoexprtape;
+        else
+            *notset = 1;
+        break;
     case OPT_NOITER:
         if (opt && OPTnoiter_given)
             value->iValue = OPTnoiter;
@@ -884,6 +915,20 @@ OPTanalysis::askQuest(const sCKT *ckt, const sJOB*, int which,
         value->iValue = task->TSKjjaccel;
         data->type = IF_FLAG;
         break;
+    case OPT_LOADBYPASS:
+        value->iValue = task->TSKloadBypass;
+        data->type = IF_FLAG;
+        break;
+#ifdef WITH_THREADS
+    case OPT_LOADBUFS:
+        value->iValue = task->TSKloadBufs;
+        data->type = IF_FLAG;
+        break;
+#endif
+    case OPT_NOEXPRTAPE:
+        value->iValue = task->TSKnoExprTape;
+        data->type = IF_FLAG;
+        break;
     case OPT_NOITER:
         value->iValue = task->TSKnoiter;
         data->type = IF_FLAG;
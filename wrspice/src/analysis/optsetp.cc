@@ -104,6 +104,11 @@ const char *spkw_forcegmin      = "forcegmin";
 const char *spkw_gminfirst      = "gminfirst";
 const char *spkw_hspice         = "hspice";
 const char *spkw_jjaccel        = "jjaccel";
+const char *spkw_loadbypass     = "loadbypass";
+#ifdef WITH_THREADS
+const char *spkw_loadbufs       = "loadbufs";
+#endif
+const char *spkw_noexprtape     = "noexprtape";
 const char *spkw_noiter         = "noiter";
 const char *spkw_nojjtp         = "nojjtp";
 const char *spkw_noklu          = "noklu";
@@ -362,6 +367,22 @@ sOPTIONS::setup(const sOPTIONS *opts, OMRG_TYPE mt)
         OPTjjaccel = opts->OPTjjaccel;
         OPTjjaccel_given = 1;
     }
+    if (opts->OPTloadbypass_given &&
+            (mt == OMRG_GLOBAL || !OPTloadbypass_given)) {
+        OPTloadbypass = opts->OPTloadbypass;
+        OPTloadbypass_given = 1;
+    }
+#ifdef WITH_THREADS
+    if (opts->OPTloadbufs_given && (mt == OMRG_GLOBAL || !OPTloadbufs_given)) {
+        OPTloadbufs = opts->OPTloadbufs;
+        OPTloadbufs_given = 1;
+    }
+#endif
+    if (opts->OPTnoexprtape_given &&
+            (mt == OMRG_GLOBAL || !OPTnoexprtape_given)) {
+        OPTnoexprtape = opts->OPTnoexprtape;
+        OPTnoexprtape_given = 1;
+    }
     if (opts->OPTnoiter_given && (mt == OMRG_GLOBAL || !OPTnoiter_given)) {
         OPTnoiter = opts->OPTnoiter;
         OPTnoiter_given = 1;
@@ -863,6 +884,32 @@ OPTanalysis::setParm(sJOB *anal, int which, IFdata *data)
         else
             opt->OPTjjaccel_given = 0;
         break;
+    case OPT_LOADBYPASS:
+        if (value) {
+            opt->OPTloadbypass = value->iValue;
+            opt->OPTloadbypass_given = 1;
+        }
+        else
+            opt->OPTloadbypass_given = 0;
+        break;
+#ifdef WITH_THREADS
+    case OPT_LOADBUFS:
+        if (value) {
+            opt->OPTloadbufs = value->iValue;
+            opt->OPTloadbufs_given = 1;
+        }
+        else
+            opt->OPTloadbufs_given = 0;
+        break;
+#endif
+    case OPT_NOEXPRTAPE:
+        if (value) {
+            opt->OPTnoexprtape = value->iValue;
+            opt->OPTnoexprtape_given = 1;
+        }
+        else
+            opt->OPTnoexprtape_given = 0;
+        break;
     case OPT_NOITER:
         if (value) {
             opt->OPTnoiter = value->iValue;
@@ -1185,6 +1232,14 @@ namespace {
             "suppress warning, promote Hspice compatibility"),
         IFparm(spkw_jjaccel,        OPT_JJACCEL,        IF_IO|IF_FLAG,
             "Accelerate Josephson-only simulation"),
+        IFparm(spkw_loadbypass,     OPT_LOADBYPASS,     IF_IO|IF_FLAG,
+            "Reuse device load contributions when quiescent"),
+#ifdef WITH_THREADS
+        IFparm(spkw_loadbufs,       OPT_LOADBUFS,       IF_IO|IF_FLAG,
+            "Use per-thread stamp buffers when loading with threads"),
+#endif
+        IFparm(spkw_noexprtape,     OPT_NOEXPRTAPE,     IF_IO|IF_FLAG,
+            "Evaluate expressions from parse trees, not compiled"),
         IFparm(spkw_noiter,         OPT_NOITER,         IF_IO|IF_FLAG,
             "Supress transient iterations past predictor"),
         IFparm(spkw_nojjtp,         OPT_NOJJTP,         IF_IO|IF_FLAG,
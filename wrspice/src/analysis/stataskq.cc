@@ -79,6 +79,14 @@ STATanalysis::askQuest(const sCKT *ckt, const sJOB*, int which,
         value->iValue = stat->STATinvolCxSwitch;
         data->type = IF_INTEGER;
         break;
+    case ST_LOADBYPASSED:
+        value->iValue = stat->STATloadBypassed;
+        data->type = IF_INTEGER;
+        break;
+    case ST_LOADEVALS:
+        value->iValue = stat->STATloadEvals;
+        data->type = IF_INTEGER;
+        break;
     case ST_LOADTIME:
         value->rValue = stat->STATloadTime;
         data->type = IF_REAL;
@@ -92,6 +100,14 @@ STATanalysis::askQuest(const sCKT *ckt, const sJOB*, int which,
         value->iValue = stat->STATloopThreads;
         data->type = IF_INTEGER;
         break;
+    case ST_LOADBUFS:
+        value->iValue = stat->STATloadBufs;
+        data->type = IF_INTEGER;
+        break;
+    case ST_LOADBUFTIME:
+        value->rValue = stat->STATloadBufTime;
+        data->type = IF_REAL;
+        break;
 #endif
     case ST_LUTIME:
         value->rValue = stat->STATdecompTime;
@@ -58,10 +58,14 @@ const char *stkw_cvchktime      = "cvchktime";
 const char *stkw_equations      = "equations";
 const char *stkw_fillin         = "fillin";
 const char *stkw_involcxswitch  = "involcxswitch";
+const char *stkw_loadbypassed   = "loadbypassed";
+const char *stkw_loadevals      = "loadevals";
 const char *stkw_loadtime       = "loadtime";
 #ifdef WITH_THREADS
 const char *stkw_loadthrds      = "loadthrds";
 const char *stkw_loopthrds      = "loopthrds";
+const char *stkw_loadbufs       = "loadbufs";
+const char *stkw_loadbuftime    = "loadbuftime";
 #endif
 const char *stkw_lutime         = "lutime";
 const char *stkw_matsize        = "matsize";
@@ -100,6 +104,7 @@ const char *stat_print_array[] =
 #ifdef WITH_THREADS
     stkw_loadthrds,
     stkw_loopthrds,
+    stkw_loadbufs,
 #endif
     "",
     stkw_totiter,
@@ -110,10 +115,15 @@ const char *stat_print_array[] =
     stkw_rejected,
     stkw_tranitercut,
     stkw_trantrapcut,
+    stkw_loadevals,
+    stkw_loadbypassed,
     "",
     stkw_time,
     stkw_trantime,
     stkw_loadtime,
+#ifdef WITH_THREADS
+    stkw_loadbuftime,
+#endif
     stkw_lutime,
     stkw_tranlutime,
     stkw_reordertime,
@@ -137,6 +147,10 @@ namespace {
             "Fill-in terms from decomposition"),
         IFparm(stkw_involcxswitch,  ST_INVOLCXSWITCH,   IF_ASK|IF_INTEGER,
             "Involuntary context switches during analysis"),
+        IFparm(stkw_loadbypassed,   ST_LOADBYPASSED,    IF_ASK|IF_INTEGER,
+            "Device instance loads bypassed"),
+        IFparm(stkw_loadevals,      ST_LOADEVALS,       IF_ASK|IF_INTEGER,
+            "Device instance loads evaluated with bypass enabled"),
         IFparm(stkw_loadtime,       ST_LOADTIME,        IF_ASK|IF_REAL,
             "Load time"),
 #ifdef WITH_THREADS
@@ -144,6 +158,10 @@ namespace {
             "Number of device loading helper threads"),
         IFparm(stkw_loopthrds,      ST_LOOPTHRDS,       IF_ASK|IF_INTEGER,
             "Number of repetitive analysis helper threads"),
+        IFparm(stkw_loadbufs,       ST_LOADBUFS,        IF_ASK|IF_INTEGER,
+            "Number of per-thread load stamp buffers"),
+        IFparm(stkw_loadbuftime,    ST_LOADBUFTIME,     IF_ASK|IF_REAL,
+            "Time spent summing load stamp buffers"),
 #endif
         IFparm(stkw_lutime,         ST_LUTIME,          IF_ASK|IF_REAL,
             "L-U decomposition time"),
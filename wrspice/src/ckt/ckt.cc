@@ -94,6 +94,8 @@ pthread_spinlock_t sCKT::CKTloadLock3;
 #ifndef THREAD_SAFE_EVAL
 pthread_mutex_t sCKT::CKTloadLock4 = PTHREAD_MUTEX_INITIALIZER;
 #endif
+pthread_mutex_t sCKT::CKTdumpLock = PTHREAD_MUTEX_INITIALIZER;
+__thread sCKTstampBuf *sCKT::CKTstampBuf;
 
 
 namespace {
@@ -117,7 +119,8 @@ namespace {
     {
         // Variable length, no constructor/destructor.
 
-        static sInstBatch *new_batch(sCKT *c, int sz)
+        static sInstBatch *new_batch(sCKT *c, int sz,
+            sCKTstampBuf *sb = 0)
             {
                 if (sz < 0)
                     return (0);
@@ -125,6 +128,7 @@ namespace {
                 sInstBatch *b = (sInstBatch*)malloc(size);
                 memset(b, 0, size);
                 b->b_ckt = c;
+                b->b_buf = sb;
                 return (b);
             }
 
@@ -134,11 +138,13 @@ namespace {
             }
 
         sCKT *ckt()                 { return (b_ckt); }
+        sCKTstampBuf *buf()         { return (b_buf); }
         int count()                 { return (b_count); }
         sGENinstance *list(int i)   { return (b_list[i]); }
 
     private:
         sCKT *b_ckt;
+        sCKTstampBuf *b_buf;
         int b_count;
         sGENinstance *b_list[1];
     };
@@ -167,6 +173,7 @@ namespace {
             };
 
         sCKT *ckt()                 { return (b_ckt); }
+        sCKTstampBuf *buf()         { return (0); }
         int count()                 { return (BATCHNO); }
         sGENinstance *list(int i)   { return (b_list[i]); }
         void set_list(sGENinstance *g, int i)   { b_list[i] = g; }
@@ -183,17 +190,39 @@ namespace {
     int thread_proc(sTPthreadData*, void *arg)
     {
         sInstBatch *b = (sInstBatch*)arg;
+
+        // If the batch has a stamp buffer, the ldadd/rhsadd calls
+        // from this thread will go there.
+        sCKTstampBuf *sb = b->buf();
+        if (sb)
+            sb->reset();
+        sCKT::CKTstampBuf = sb;
+
+        sCKT *ckt = b->ckt();
+        bool bypass = ckt->CKTbypassOn;
+        int nevals = 0, nbypass = 0;
         for (int i = 0; i < b->count(); i++) {
             sGENinstance *d = b->list(i);
             if (!d)
                 break;
             sGENmodel *m = d->GENmodPtr;
-            int error = DEV.device(m->GENmodType)->load(d, b->ckt());
+            IFdevice *dev = DEV.device(m->GENmodType);
+            int error;
+            if (bypass && (dev->flags() & DV_BYPASS)) {
+                error = ckt->loadBypass(dev, d, &nbypass);
+                nevals++;
+            }
+            else
+                error = dev->load(d, ckt);
             if (error != OK && error != LOAD_SKIP_FLAG) {
                 // Shouldn't see the skip flag.
+                sCKT::CKTstampBuf = 0;
                 return (error);
             }
         }
+        sCKT::CKTstampBuf = 0;
+        if (bypass)
+            ckt->addLoadCounts(nevals - nbypass, nbypass);
         return (0);
     }
 
@@ -206,9 +235,212 @@ namespace {
     }
 }
 
+#else
+sCKTstampBuf *sCKT::CKTstampBuf;
 #endif // WITH_THREADS
 
 
+
+// Grow the matrix entry list, doubling the size.
+//
+void
+sCKTstampBuf::grow_mat()
+{
+    unsigned int nsz = sb_msize ? 2*sb_msize : 256;
+    sMent *tmp = new sMent[nsz];
+    if (sb_nmat)
+        memcpy(tmp, sb_mat, sb_nmat*sizeof(sMent));
+    delete [] sb_mat;
+    sb_mat = tmp;
+    sb_msize = nsz;
+}
+
+
+// Grow the rhs entry list, doubling the size.
+//
+void
+sCKTstampBuf::grow_rhs()
+{
+    unsigned int nsz = sb_rsize ? 2*sb_rsize : 64;
+    sRent *tmp = new sRent[nsz];
+    if (sb_nrhs)
+        memcpy(tmp, sb_rhs, sb_nrhs*sizeof(sRent));
+    delete [] sb_rhs;
+    sb_rhs = tmp;
+    sb_rsize = nsz;
+}
+
+
+// Sum the saved contributions into the matrix and rhs.  This is
+// called from the main thread only, after the workers have finished.
+//
+void
+sCKTstampBuf::reduce(double *rhs, bool extprec) const
+{
+    if (extprec) {
+        for (unsigned int i = 0; i < sb_nmat; i++)
+            *(long double*)sb_mat[i].ptr += sb_mat[i].val;
+    }
+    else {
+        for (unsigned int i = 0; i < sb_nmat; i++)
+            *sb_mat[i].ptr += sb_mat[i].val;
+    }
+    for (unsigned int i = 0; i < sb_nrhs; i++)
+        rhs[sb_rhs[i].ix] += sb_rhs[i].val;
+}
+
+
+// Add the saved contributions through the circuit load functions,
+// which may direct them to another buffer.  This can be called from
+// any thread.
+//
+void
+sCKTstampBuf::replay(sCKT *ckt) const
+{
+    for (unsigned int i = 0; i < sb_nmat; i++)
+        ckt->ldadd(sb_mat[i].ptr, sb_mat[i].val);
+    for (unsigned int i = 0; i < sb_nrhs; i++)
+        ckt->rhsadd(sb_rhs[i].ix, sb_rhs[i].val);
+}
+
+
+// Reallocate the lists to the size in use, for buffers that are
+// kept per instance.
+//
+void
+sCKTstampBuf::compact()
+{
+    if (sb_msize > sb_nmat) {
+        sMent *tmp = 0;
+        if (sb_nmat) {
+            tmp = new sMent[sb_nmat];
+            memcpy(tmp, sb_mat, sb_nmat*sizeof(sMent));
+        }
+        delete [] sb_mat;
+        sb_mat = tmp;
+        sb_msize = sb_nmat;
+    }
+    if (sb_rsize > sb_nrhs) {
+        sRent *tmp = 0;
+        if (sb_nrhs) {
+            tmp = new sRent[sb_nrhs];
+            memcpy(tmp, sb_rhs, sb_nrhs*sizeof(sRent));
+        }
+        delete [] sb_rhs;
+        sb_rhs = tmp;
+        sb_rsize = sb_nrhs;
+    }
+}
+// End of sCKTstampBuf functions.
+
+
+// Return true if none of the watched node voltages in rhs differ
+// from the saved values by more than the tolerance.
+//
+bool
+sCKTbypass::quiet(const double *rhs, double reltol, double vntol) const
+{
+    for (unsigned int i = 0; i < bp_nnodes; i++) {
+        double v = rhs[bp_nodes[i]];
+        double vo = bp_volts[i];
+        double tol = reltol*SPMAX(fabs(v), fabs(vo)) + vntol;
+        if (fabs(v - vo) > tol)
+            return (false);
+    }
+    return (true);
+}
+
+
+// Save the voltages used in an evaluation of inst.  The watched
+// nodes are the instance terminals, plus the nodes that receive rhs
+// contributions, which include the device internal nodes.
+//
+void
+sCKTbypass::save_volts(sGENinstance *inst, const double *rhs)
+{
+    unsigned int sz = inst->numnodes() + bp_stamps.num_rhs();
+    if (sz > bp_nsize) {
+        delete [] bp_nodes;
+        delete [] bp_volts;
+        bp_nodes = new int[sz];
+        bp_volts = new double[sz];
+        bp_nsize = sz;
+    }
+    unsigned int n = 0;
+    for (int i = 1; i <= inst->numnodes(); i++) {
+        int nd = *inst->nodeptr(i);
+        if (nd > 0)
+            bp_nodes[n++] = nd;
+    }
+    for (unsigned int i = 0; i < bp_stamps.num_rhs(); i++) {
+        int nd = bp_stamps.rhs_index(i);
+        if (nd <= 0)
+            continue;
+        unsigned int j = 0;
+        for ( ; j < n; j++) {
+            if (bp_nodes[j] == nd)
+                break;
+        }
+        if (j == n)
+            bp_nodes[n++] = nd;
+    }
+    for (unsigned int i = 0; i < n; i++)
+        bp_volts[i] = rhs[bp_nodes[i]];
+    bp_nnodes = n;
+}
+// End of sCKTbypass functions.
+
+
+// Fill in the flat instance index from the model lists.  The arrays
+// are retained and reused if large enough.
+//
+void
+sCKTinstTab::build(const sCKTmodHead &mh)
+{
+    unsigned int ni = 0, ns = 0;
+    sCKTmodGen mgen(mh);
+    for (sGENmodel *m = mgen.next(); m; m = mgen.next()) {
+        for (sGENmodel *dm = m; dm; dm = dm->GENnextModel) {
+            ns++;
+            for (sGENinstance *d = dm->GENinstances; d;
+                    d = d->GENnextInstance)
+                ni++;
+        }
+    }
+    if (ni > it_instSize) {
+        delete [] it_insts;
+        it_insts = new sGENinstance*[ni];
+        it_instSize = ni;
+    }
+    if (ns > it_spanSize) {
+        delete [] it_spans;
+        it_spans = new sCKTinstSpan[ns];
+        it_spanSize = ns;
+    }
+
+    ni = 0;
+    ns = 0;
+    mgen = sCKTmodGen(mh);
+    for (sGENmodel *m = mgen.next(); m; m = mgen.next()) {
+        IFdevice *dev = DEV.device(m->GENmodType);
+        for (sGENmodel *dm = m; dm; dm = dm->GENnextModel) {
+            sCKTinstSpan *s = it_spans + ns++;
+            s->model = dm;
+            s->dev = dev;
+            s->start = ni;
+            for (sGENinstance *d = dm->GENinstances; d;
+                    d = d->GENnextInstance)
+                it_insts[ni++] = d;
+            s->count = ni - s->start;
+        }
+    }
+    it_numInsts = ni;
+    it_numSpans = ns;
+    it_valid = true;
+}
+// End of sCKTinstTab functions.
+
+
 sGENmodel::~sGENmodel()
 {
     delete GENinstTab;
@@ -266,6 +498,14 @@ sCKT::~sCKT()
     delete CKTmacroTab;
 
     delete CKTloadPool;
+#ifdef WITH_THREADS
+    delete [] CKTstampBufs;
+#endif
+    while (CKTbypassList) {
+        sCKTbypass *bx = CKTbypassList;
+        CKTbypassList = CKTbypassList->bp_next;
+        delete bx;
+    }
 
     if (CKTbackPtr && CKTbackPtr->runckt() == this)
         CKTbackPtr->set_runckt(0);
@@ -491,6 +731,7 @@ sCKT::delInst(sGENmodel *model, IFuid uid, sGENinstance *inst)
         }
         model = inst->GENmodPtr;
     }
+    CKTinstTab.invalidate();
     return (DEV.device(model->GENmodType)->delInst(model, uid, inst));
 }
 
@@ -515,6 +756,7 @@ sCKT::delModl(sGENmodel **modelp, IFuid moduid, sGENmodel *fast)
         if (mx)
             modelp = &mx->head;
     }
+    CKTinstTab.invalidate();
     return (DEV.device((*modelp)->GENmodType)->delModl(modelp, moduid, fast));
 }
 
@@ -571,6 +813,7 @@ sCKT::doTask(bool reset)
 #ifdef WITH_THREADS
                 CKTstat->STATloadThreads = 0;
                 CKTstat->STATloopThreads = 0;
+                CKTstat->STATloadBufs = 0;
 #endif
                 error = IFanalysis::analysis(i)->anFunc(this, reset);
 #ifdef HAVE_GETRUSAGE
@@ -982,6 +1225,35 @@ sCKT::load(bool noclear)
     CKTtrapCheck = tchk && (CKTmode & MODEINITFLOAT) && (CKTmode & MODETRAN);
     CKTtrapBad = false;
 
+    // Set up load bypass.  Saved device contributions are reused
+    // only in the iterations of the same load context, which must
+    // have every parameter that enters the device equations other
+    // than the node voltages unchanged.  The trapezoid check needs
+    // every device evaluated.
+    //
+    CKTbypassOn = CKTcurTask->TSKloadBypass &&
+        (CKTmode & MODEINITFLOAT) && !CKTtrapCheck;
+    if (!CKTbypassOn || CKTmode != CKTbypassCtx.mode ||
+            CKTorder != CKTbypassCtx.order ||
+            CKTtime != CKTbypassCtx.time ||
+            CKTdelta != CKTbypassCtx.delta ||
+            CKTsrcFact != CKTbypassCtx.srcfact ||
+            CKTdiagGmin != CKTbypassCtx.diaggmin ||
+            CKTcurTask->TSKgmin != CKTbypassCtx.gmin ||
+            memcmp(CKTag, CKTbypassCtx.ag, sizeof(CKTag))) {
+        CKTbypassEpoch++;
+        if (!CKTbypassEpoch)
+            CKTbypassEpoch++;
+        memcpy(CKTbypassCtx.ag, CKTag, sizeof(CKTag));
+        CKTbypassCtx.time = CKTtime;
+        CKTbypassCtx.delta = CKTdelta;
+        CKTbypassCtx.srcfact = CKTsrcFact;
+        CKTbypassCtx.diaggmin = CKTdiagGmin;
+        CKTbypassCtx.gmin = CKTcurTask->TSKgmin;
+        CKTbypassCtx.mode = CKTmode;
+        CKTbypassCtx.order = CKTorder;
+    }
+
     // Mutual inductors must be loaded before the inductor devices. 
     // We'll load them now.  The order sensitivity could probably be
     // fixed, but there is a thread sync issue that would need to be
@@ -998,6 +1270,10 @@ sCKT::load(bool noclear)
         }
     }
 
+    // The instance index is normally built in setup.
+    if (!CKTinstTab.valid())
+        CKTinstTab.build(CKTmodels);
+
 #ifdef WITH_THREADS
 #ifdef NEW_THREAD_QUEUE
     // The new thread queue, seems a bit faster than the original. 
@@ -1006,54 +1282,52 @@ sCKT::load(bool noclear)
     // the work.
 
     if (CKTcurTask->TSKloadThreads > 0) {
+        bool usebufs = CKTcurTask->TSKloadBufs;
         if (!CKTloadPool ||
-                ((int)CKTloadPool->num_threads() != CKTloadThreads)) {
+                ((int)CKTloadPool->num_threads() != CKTloadThreads) ||
+                (usebufs != (CKTstampBufs != 0))) {
             CKTloadThreads = CKTcurTask->TSKloadThreads;
 
-            // Count the number of devices to load.
-            int dcnt = 0;
-            sCKTmodGen mgen(CKTmodels);
-            for (sGENmodel *m = mgen.next(); m; m = mgen.next()) {
-                if (m->GENmodType == muttype)
-                    continue;
-                for (sGENmodel *dm = m; dm; dm = dm->GENnextModel) {
-                    for (sGENinstance *d = dm->GENinstances; d; 
-                            d = d->GENnextInstance) {
-                        int ret = DEV.device(m->GENmodType)->loadTest(d, this);
-                        if (ret == LOAD_SKIP_FLAG)
-                            break;
-                        dcnt++;
-                    }
-                }
-            }
+            // The instance count is an upper bound of the number of
+            // devices to load, the job structs are filled in a single
+            // pass below.
+            int dcnt = CKTinstTab.numInsts();
             int njobs = CKTloadThreads + 1;  // worker threads plus primary
             int batchno = dcnt/njobs + (dcnt%njobs != 0);
 
+            // If using private stamp buffers, there is one per job.
+            delete [] CKTstampBufs;
+            CKTstampBufs = 0;
+            CKTnumStampBufs = 0;
+            if (usebufs) {
+                CKTstampBufs = new sCKTstampBuf[njobs];
+                CKTnumStampBufs = njobs;
+            }
+
             // Allocate the job structs.
             sBatchList *batch = 0;
             for (int i = 0; i < njobs; i++) {
                 batch = new sBatchList(
-                    sInstBatch::new_batch(this, batchno), batch);
+                    sInstBatch::new_batch(this, batchno,
+                    CKTstampBufs ? CKTstampBufs + i : 0), batch);
             }
 
             // Fill the job structs, ordering to spread each device type
             // between jobs for good balance.
             sBatchList *b = batch;
-            mgen = sCKTmodGen(CKTmodels);
-            for (sGENmodel *m = mgen.next(); m; m = mgen.next()) {
-                if (m->GENmodType == muttype)
+            for (unsigned int k = 0; k < CKTinstTab.numSpans(); k++) {
+                const sCKTinstSpan *sp = CKTinstTab.span(k);
+                if (sp->model->GENmodType == muttype)
                     continue;
-                for (sGENmodel *dm = m; dm; dm = dm->GENnextModel) {
-                    for (sGENinstance *d = dm->GENinstances; d; 
-                            d = d->GENnextInstance) {
-                        int ret = DEV.device(m->GENmodType)->loadTest(d, this);
-                        if (ret == LOAD_SKIP_FLAG)
-                            break;
-                        b->batch->append(d);
-                        b = b->next;
-                        if (!b)
-                            b = batch;
-                    }
+                sGENinstance **insts = CKTinstTab.insts(sp);
+                for (unsigned int i = 0; i < sp->count; i++) {
+                    int ret = sp->dev->loadTest(insts[i], this);
+                    if (ret == LOAD_SKIP_FLAG)
+                        break;
+                    b->batch->append(insts[i]);
+                    b = b->next;
+                    if (!b)
+                        b = batch;
                 }
             }
 
@@ -1077,6 +1351,17 @@ sCKT::load(bool noclear)
             CKTtrapCheck = tchk;
             return (error);
         }
+        if (CKTstampBufs) {
+            // All threads are done, add the buffered contributions
+            // into the matrix.  This is done in a fixed order, so
+            // results don't depend on thread scheduling.
+
+            double rtime = OP.seconds();
+            for (int i = 0; i < CKTnumStampBufs; i++)
+                CKTstampBufs[i].reduce(CKTrhs, CKTextPrec);
+            CKTstat->STATloadBufTime += OP.seconds() - rtime;
+            CKTstat->STATloadBufs = CKTnumStampBufs;
+        }
     }
     else
 
@@ -1099,26 +1384,24 @@ sCKT::load(bool noclear)
 
             sInstBatch *batch = 0;
             int j = 0;
-            sCKTmodGen mgen(CKTmodels);
-            for (sGENmodel *m = mgen.next(); m; m = mgen.next()) {
-                if (m->GENmodType == muttype)
+            for (unsigned int k = 0; k < CKTinstTab.numSpans(); k++) {
+                const sCKTinstSpan *sp = CKTinstTab.span(k);
+                if (sp->model->GENmodType == muttype)
                     continue;
-                for (sGENmodel *dm = m; dm; dm = dm->GENnextModel) {
-                    for (sGENinstance *d = dm->GENinstances; d;
-                            d = d->GENnextInstance) {
-                        int ret = DEV.device(m->GENmodType)->loadTest(d, this);
-                        if (ret == LOAD_SKIP_FLAG)
-                            break;
-                        if (!batch)
-                            batch = new sInstBatch(this);
-                        if (j == BATCHNO) {
-                            j = 0;
-                            CKTloadPool->submit(thread_proc, batch,
-                                destroy_proc);
-                            batch = new sInstBatch(this);
-                        }
-                        batch->set_list(d, j++);
+                sGENinstance **insts = CKTinstTab.insts(sp);
+                for (unsigned int i = 0; i < sp->count; i++) {
+                    int ret = sp->dev->loadTest(insts[i], this);
+                    if (ret == LOAD_SKIP_FLAG)
+                        break;
+                    if (!batch)
+                        batch = new sInstBatch(this);
+                    if (j == BATCHNO) {
+                        j = 0;
+                        CKTloadPool->submit(thread_proc, batch,
+                            destroy_proc);
+                        batch = new sInstBatch(this);
                     }
+                    batch->set_list(insts[i], j++);
                 }
             }
             if (batch && batch->list(0)) {
@@ -1137,33 +1420,50 @@ sCKT::load(bool noclear)
 #endif
 #endif
     {
-        sCKTmodGen mgen(CKTmodels);
-        for (sGENmodel *m = mgen.next(); m; m = mgen.next()) {
-            if (m->GENmodType == muttype)
+        int nevals = 0, nbypass = 0;
+        for (unsigned int k = 0; k < CKTinstTab.numSpans(); k++) {
+            const sCKTinstSpan *sp = CKTinstTab.span(k);
+            if (sp->model->GENmodType == muttype)
                 continue;
-            for (sGENmodel *dm = m; dm; dm = dm->GENnextModel) {
-                int noncon = CKTnoncon;
-                for (sGENinstance *d = dm->GENinstances; d;
-                        d = d->GENnextInstance) {
-                    int error = DEV.device(m->GENmodType)->load(d, this);
+            IFdevice *dev = sp->dev;
+            sGENinstance **insts = CKTinstTab.insts(sp);
+            int n = sp->count;
+            int noncon = CKTnoncon;
+            if (CKTbypassOn && (dev->flags() & DV_BYPASS)) {
+                // Reuse saved contributions where the instance
+                // voltages are unchanged.
+                for (int i = 0; i < n; i++) {
+                    int error = loadBypass(dev, insts[i], &nbypass);
                     if (error == LOAD_SKIP_FLAG)
                         break;
                     if (error) {
                         CKTtrapCheck = tchk;
                         return (error);
                     }
+                    nevals++;
                 }
-                if (CKTstepDebug) {
-                    if (noncon != CKTnoncon) {
-                        TTY.err_printf(
-                            "device type %s nonconvergence (%d tests)\n",
-                            DEV.device(m->GENmodType)->name(),
-                            CKTnoncon - noncon);
-                        noncon = CKTnoncon;
+            }
+            else {
+                for (int i = 0; i < n; i++) {
+                    int error = dev->load(insts[i], this);
+                    if (error == LOAD_SKIP_FLAG)
+                        break;
+                    if (error) {
+                        CKTtrapCheck = tchk;
+                        return (error);
                     }
                 }
             }
+            if (CKTstepDebug) {
+                if (noncon != CKTnoncon) {
+                    TTY.err_printf(
+                        "device type %s nonconvergence (%d tests)\n",
+                        dev->name(), CKTnoncon - noncon);
+                }
+            }
         }
+        if (CKTbypassOn)
+            addLoadCounts(nevals - nbypass, nbypass);
     }
 
     CKTtrapCheck = tchk;
@@ -1201,6 +1501,112 @@ sCKT::load(bool noclear)
 }
 
 
+// Load the instance d, or reuse the contributions saved from the last
+// evaluation in this load context if the instance voltages have not
+// moved beyond the convergence tolerances.  The count is incremented
+// if the load is bypassed.  The contributions are always added
+// through ldadd/rhsadd, so this works with any load buffering.
+//
+// Records are invalidated if the device reports nonconvergence when
+// evaluated, as the contributions then reflect limited voltages.
+//
+int
+sCKT::loadBypass(IFdevice *dev, sGENinstance *d, int *nbp)
+{
+    sCKTbypass *bp = d->GENbypass;
+    if (bp && bp->bp_inst != d) {
+        // The instance struct was copied, the record belongs to the
+        // original.
+        bp = 0;
+    }
+    if (bp && bp->bp_epoch == CKTbypassEpoch &&
+            bp->quiet(CKTrhsOld, CKTcurTask->TSKreltol,
+            CKTcurTask->TSKvoltTol)) {
+        bp->bp_stamps.replay(this);
+        (*nbp)++;
+        return (OK);
+    }
+    if (!bp) {
+        bp = newBypass();
+        bp->bp_inst = d;
+        d->GENbypass = bp;
+    }
+
+    sCKTstampBuf *sbuf = CKTstampBuf;
+    bp->bp_stamps.reset();
+    CKTstampBuf = &bp->bp_stamps;
+    int noncon = CKTnoncon;
+    int error = dev->load(d, this);
+    CKTstampBuf = sbuf;
+    bp->bp_stamps.replay(this);
+
+    if (error != OK || noncon != CKTnoncon) {
+        // With threads, another instance may have bumped the count,
+        // this simply costs a bypass opportunity.
+        bp->bp_epoch = 0;
+        return (error);
+    }
+    bp->bp_stamps.compact();
+    bp->save_volts(d, CKTrhsOld);
+    bp->bp_epoch = CKTbypassEpoch;
+    return (OK);
+}
+
+
+// Return a new bypass record, which is linked into the circuit list
+// and freed with the circuit.  This can be called from the loading
+// threads.
+//
+sCKTbypass *
+sCKT::newBypass()
+{
+    sCKTbypass *bp = new sCKTbypass;
+#ifdef WITH_THREADS
+    if (CKTloadThreads) {
+#ifdef WITH_ATOMIC
+        do {
+            bp->bp_next = CKTbypassList;
+        } while (!__sync_bool_compare_and_swap(&CKTbypassList,
+            bp->bp_next, bp));
+#else
+        pthread_spin_lock(&CKTloadLock1);
+        bp->bp_next = CKTbypassList;
+        CKTbypassList = bp;
+        pthread_spin_unlock(&CKTloadLock1);
+#endif
+        return (bp);
+    }
+#endif
+    bp->bp_next = CKTbypassList;
+    CKTbypassList = bp;
+    return (bp);
+}
+
+
+// Add to the device evaluation and bypass counts in the statistics.
+//
+void
+sCKT::addLoadCounts(int nevals, int nbypass)
+{
+#ifdef WITH_THREADS
+    if (CKTloadThreads) {
+#ifdef WITH_ATOMIC
+        __sync_fetch_and_add(&CKTstat->STATloadEvals, nevals);
+        __sync_fetch_and_add(&CKTstat->STATloadBypassed, nbypass);
+#else
+        pthread_spin_lock(&CKTloadLock1);
+        CKTstat->STATloadEvals += nevals;
+        CKTstat->STATloadBypassed += nbypass;
+        pthread_spin_unlock(&CKTloadLock1);
+#endif
+        return;
+    }
+#endif
+    CKTstat->STATloadEvals += nevals;
+    CKTstat->STATloadBypassed += nbypass;
+}
+
+
 // This function adds diagGmin to voltage nodes when diagGmin is
 // nonzero.  Otherwise, if enabled, it will ensure that all of these
 // (diagonal) elements have a minimum value of the circuit gmin.  This
@@ -1331,6 +1737,8 @@ sCKT::backup(DEV_BKMODE bmd)
         memcpy(CKToldState0, CKTstate0, CKTnumStates*sizeof(double));
     }
     else if (bmd == DEV_RESTORE) {
+        // Saved load bypass contributions are stale.
+        CKTbypassEpoch++;
         int sz = CKTmatrix->spGetSize(1) + 1;
         if (CKToldSol)
             memcpy(CKTrhsOld, CKToldSol, sz*sizeof(double));
@@ -1385,6 +1793,7 @@ sCKT::newInst(sGENmodel *modPtr, sGENinstance **inInstPtr, IFuid name)
     if (!modPtr->GENinstTab)
         modPtr->GENinstTab = new sGENinstTable;
     modPtr->GENinstTab->link(instPtr);
+    CKTinstTab.invalidate();
 
     if (inInstPtr != 0)
         *inInstPtr = instPtr;
@@ -1415,6 +1824,7 @@ sCKT::newModl(int type, sGENmodel **modfast, IFuid name)
         }
         else
             CKTmodels.insert(mymodfast);
+        CKTinstTab.invalidate();
         if (modfast)
             *modfast = mymodfast;
         return (OK);
@@ -2202,6 +2612,9 @@ sCKT::setup()
             return (error);
     }
 
+    // Index the instances for loading.
+    CKTinstTab.build(CKTmodels);
+
     CKTstateSize = CKTnumStates;
     for (int i = 0; i < 8; i++) {
         delete [] CKTstates[i];
@@ -2256,6 +2669,10 @@ sCKT::unsetup()
 int
 sCKT::resetup()
 {
+    // The matrix pointers in saved load bypass contributions are
+    // no longer valid.
+    CKTbypassEpoch++;
+
     sCKTmodGen mgen(CKTmodels);
     for (sGENmodel *m = mgen.next(); m; m = mgen.next()) {
         int error = DEV.device(m->GENmodType)->resetup(m, this);
@@ -481,7 +481,17 @@ sJobc::register_job(sCHECKprms *job)
         }
         cnt++;
     }
-    if (!cnt) {
+
+    // If no servers, or the checkjobs variable is set, run trials in
+    // processes on the local machine.  Each local process that
+    // completes is given a new trial in check_jobs, so that this
+    // number of processes is kept running.
+    int nloc = cnt ? 0 : 1;
+    VTvalue vj;
+    if (Sp.GetVar(kw_checkjobs, VTYP_NUM, &vj, job->out_cir) &&
+            vj.get_int() > 0)
+        nloc = vj.get_int();
+    if (nloc > 0) {
         const char *program = 0;
         VTvalue vv;
         if (!Sp.GetVar(kw_rprogram, VTYP_STRING, &vv))
@@ -496,12 +506,15 @@ sJobc::register_job(sCHECKprms *job)
                     program = CP.Program();
             }
         }
-        if (job->nextTask(&rj->i, &rj->j))
-            // no more jobs
-            return;
-        if (submit("local", program, 0, 0, job->out_cir, rj)) {
-            int num1 = 2*job->step1() + 1;
-            job->set_pflag((rj->j + job->step2())*num1 + rj->i, 0);
+        for (int i = 0; i < nloc; i++) {
+            if (job->nextTask(&rj->i, &rj->j))
+                // no more jobs
+                return;
+            if (submit("local", program, 0, 0, job->out_cir, rj)) {
+                int num1 = 2*job->step1() + 1;
+                job->set_pflag((rj->j + job->step2())*num1 + rj->i, 0);
+                break;
+            }
         }
     }
 }
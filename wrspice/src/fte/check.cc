@@ -441,7 +441,7 @@ checkargs::parse(wordlist **pwl, const char **pe, const char **po)
         "   -h    Show this message\n"
         "   -k    Save all data\n"
         "   -m    Perform Monte Carlo analysis\n"
-        "   -r    Use remote servers\n"
+        "   -r    Use remote servers or local processes\n"
         "   -s    Save data during each trial and dump it\n"
         "   -v    Verbose mode\n\n"
         ;
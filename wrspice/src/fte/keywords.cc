@@ -2254,6 +2254,7 @@ sKW *cKeyWords::KWunits[] = {
 // the command configuration keywords
 const char *kw_appendwrite      = "appendwrite";
 const char *kw_checkiterate     = "checkiterate";
+const char *kw_checkjobs        = "checkjobs";
 const char *kw_diff_abstol      = "diff_abstol";
 const char *kw_diff_reltol      = "diff_reltol";
 const char *kw_diff_vntol       = "diff_vntol";
@@ -2337,6 +2338,32 @@ struct KWent_checkiterate : public KWent
     }
 };
 
+struct KWent_checkjobs : public KWent
+{
+    KWent_checkjobs() { set(
+        kw_checkjobs,
+        VTYP_NUM, DEF_checkjobs_MIN, DEF_checkjobs_MAX,
+        "Local processes for check -r trials."); }
+
+    void callback(bool isset, variable *v)
+    {
+        if (isset) {
+            if (v->type() == VTYP_REAL && v->real() >= min &&
+                    v->real() <= max) {
+                int val = (int)v->real();
+                v->set_integer(val);
+            }
+            else if (!(v->type() == VTYP_NUM && v->integer() >= min &&
+                    v->integer() <= max)) {
+                error_pr(word, 0, pr_integer((int)min, (int)max));
+                return;
+            }
+        }
+        CP.RawVarSet(word, isset, v);
+        KWent::callback(isset, v);
+    }
+};
+
 struct KWent_diff_abstol : public KWent
 {
     KWent_diff_abstol() { set(
@@ -3242,6 +3269,7 @@ struct KWent_xicpath : public KWent
 sKW *cKeyWords::KWcmds[] = {
     new KWent_appendwrite(),
     new KWent_checkiterate(),
+    new KWent_checkjobs(),
     new KWent_diff_abstol(),
     new KWent_diff_reltol(),
     new KWent_diff_vntol(),
@@ -4886,6 +4914,59 @@ struct KWent_jjaccel : public KWent
     }
 };
 
+struct KWent_loadbypass : public KWent
+{
+    KWent_loadbypass() { set(
+        spkw_loadbypass,
+        VTYP_BOOL, 0.0, 0.0,
+        "Reuse device load contributions when quiescent."); }
+
+    void callback(bool isset, variable *v)
+    {
+        if (isset)
+            v->set_boolean(true);
+        if (checknset(word, isset, v))
+            return;
+        KWent::callback(isset, v);
+    }
+};
+
+#ifdef WITH_THREADS
+struct KWent_loadbufs : public KWent
+{
+    KWent_loadbufs() { set(
+        spkw_loadbufs,
+        VTYP_BOOL, 0.0, 0.0,
+        "Use per-thread stamp buffers when loading with threads."); }
+
+    void callback(bool isset, variable *v)
+    {
+        if (isset)
+            v->set_boolean(true);
+        if (checknset(word, isset, v))
+            return;
+        KWent::callback(isset, v);
+    }
+};
+#endif
+
+struct KWent_noexprtape : public KWent
+{
+    KWent_noexprtape() { set(
+        spkw_noexprtape,
+        VTYP_BOOL, 0.0, 0.0,
+        "Evaluate expressions from parse trees, not compiled."); }
+
+    void callback(bool isset, variable *v)
+    {
+        if (isset)
+            v->set_boolean(true);
+        if (checknset(word, isset, v))
+            return;
+        KWent::callback(isset, v);
+    }
+};
+
 struct KWent_noiter : public KWent
 {
     KWent_noiter() { set(
@@ -5477,7 +5558,9 @@ sKW *cKeyWords::KWsim[] = {
     new KWent_itl2src(),
     new KWent_itl4(),
     new KWent_jjaccel(),
+    new KWent_loadbypass(),
 #ifdef WITH_THREADS
+    new KWent_loadbufs(),
     new KWent_loadthrds(),
     new KWent_loopthrds(),
 #endif
@@ -5488,6 +5571,7 @@ sKW *cKeyWords::KWsim[] = {
     new KWent_modelcard(),
     new KWent_pexnodes(),
     new KWent_nobjthack(),
+    new KWent_noexprtape(),
     new KWent_noiter(),
     new KWent_nojjtp(),
     new KWent_noklu(),
@@ -5567,6 +5651,11 @@ sKW *cKeyWords::KWsim[] = {
     new KWent_gminfirst(),
     new KWent_hspice(),
     new KWent_jjaccel(),
+    new KWent_loadbypass(),
+#ifdef WITH_THREADS
+    new KWent_loadbufs(),
+#endif
+    new KWent_noexprtape(),
     new KWent_noiter(),
     new KWent_nojjtp(),
     new KWent_noklu(),
@@ -122,6 +122,15 @@ new type:  if expr
 evaluate expr at prev point set false if not true
 */
 
+sMfunc::~sMfunc()
+{
+    delete [] f_expr;
+    delete f_tree;
+    delete f_xbuf;
+    delete f_ybuf;
+}
+
+
 void
 sMfunc::print(sLstr &lstr)
 {
@@ -145,6 +154,54 @@ sMfunc::print(sLstr &lstr)
     lstr.add_c(' ');
     lstr.add(f_expr);
 }
+
+
+// Clear the result and the streaming state.
+//
+void
+sMfunc::reset()
+{
+    f_error = false;
+    f_val   = 0.0;
+    delete f_xbuf;
+    f_xbuf  = 0;
+    delete f_ybuf;
+    f_ybuf  = 0;
+    f_y[0]  = 0.0;
+    f_y[1]  = 0.0;
+    f_y[2]  = 0.0;
+    f_ys    = 0.0;
+    f_sv    = 0.0;
+    f_min   = 0.0;
+    f_max   = 0.0;
+    f_sum   = 0.0;
+    f_sum2  = 0.0;
+}
+
+
+// Evaluate the expression at the current point, saving the value for
+// point n in the three-point history.  This is used when streaming,
+// the plot vectors hold the current point only.
+//
+void
+sMfunc::stream_eval(int n)
+{
+    if (f_error)
+        return;
+    if (!f_tree) {
+        const char *s = f_expr;
+        f_tree = Sp.GetPnode(&s, true);
+        if (f_tree)
+            f_tree->copyvecs();
+    }
+    sDataVec *dv = f_tree ? Sp.Evaluate(f_tree) : 0;
+    if (!dv) {
+        f_error = true;
+        f_val = 0.0;
+        return;
+    }
+    f_y[n%3] = dv->realval(0);
+}
 // End of sMfunc functions.
 
 
@@ -345,6 +402,19 @@ namespace {
 }
 
 
+// Set up from the run plot scale vector, which is scalarized.
+//
+void
+sMscale::set(sDataVec *xs)
+{
+    x = xs->realval(0);
+    indx = xs->unscalarized_length() - 1;
+    xprev = indx > 0 ? xs->unscalarized_prev_real() : x;
+    xfirst = xs->unscalarized_first();
+}
+// End of sMscale functions.
+
+
 sMpoint::~sMpoint()
 {
     delete t_conj;
@@ -751,10 +821,12 @@ sMpoint::print(sLstr &lstr)
 }
 
 
-// Return true if the specified point has been logically reached.
+// Return true if the specified point has been logically reached.  The
+// sc gives the scale values and index of the current point.
 //
 bool
-sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, sMpoint *mpprev)
+sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, const sMscale &sc,
+    sMpoint *mpprev)
 {
     if (!t_active)
         return (true);
@@ -764,10 +836,8 @@ sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, sMpoint *mpprev)
 
         if (t_td_given)
             t_offset = t_td;
-        else {
-            sDataVec *xs = circuit->runplot()->scale();
-            t_offset = xs->unscalarized_first();
-        }
+        else
+            t_offset = sc.xfirst;
 
         if (t_type == MPnum) {
 #ifdef M_DEBUG
@@ -870,10 +940,9 @@ sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, sMpoint *mpprev)
     }
 
     if (t_offset_set && !t_found_local) {
-        sDataVec *xs = circuit->runplot()->scale();
-        int ix = check_trig(xs);
+        int ix = check_trig(sc);
 #ifdef M_DEBUG
-        printf("at xs=%g indx=%d\n", xs->realval(0), ix);
+        printf("at xs=%g indx=%d\n", sc.x, ix);
 #endif
         if (ix < 0) {
             isready = false;
@@ -883,7 +952,7 @@ sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, sMpoint *mpprev)
         double fval = t_offset;
         if (t_type == MPnum) {
             if (!mpprev)
-                fval = xs->realval(ix);
+                fval = ix == sc.indx ? sc.x : sc.xprev;
         }
         else if (t_type == MPmref) {
             // nothing to do
@@ -899,8 +968,8 @@ sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, sMpoint *mpprev)
                 isready = false;
                 goto done;
             }
-            ix = xs->unscalarized_length() - 1;
-            fval = xs->realval(0);;
+            ix = sc.indx;
+            fval = sc.x;
             if (end)
                 ix--;
         }
@@ -923,8 +992,8 @@ sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, sMpoint *mpprev)
                 isready = false;
                 goto done;
             }
-            double x = xs->realval(0);
-            ix = xs->unscalarized_length() - 1;
+            double x = sc.x;
+            ix = sc.indx;
             if (t_v1 <= t_v2 && v2 < v1) {
                 t_rise_cnt++;
                 t_cross_cnt++;
@@ -944,7 +1013,7 @@ sMpoint::check_found(sFtCirc *circuit, bool *err, bool end, sMpoint *mpprev)
                     t_cross_cnt >= t_crosses) {
                 double d = v2 - t_v2 - (v1 - t_v1);
                 if (d != 0.0) {
-                    double xp = xs->unscalarized_prev_real();
+                    double xp = sc.xprev;
                     fval = xp + (x - xp)*(t_v1 - t_v2)/d;
                 }
                 else
@@ -972,7 +1041,7 @@ done:
         isready = !isready;
 
     if (t_conj) {
-        if (!t_conj->check_found(circuit, err, end, this))
+        if (!t_conj->check_found(circuit, err, end, sc, this))
             isready = false;
     }
     if (t_found_local && !t_ready) {
@@ -995,12 +1064,12 @@ done:
 // time point due to numerical error.
 //
 int
-sMpoint::check_trig(sDataVec *xs)
+sMpoint::check_trig(const sMscale &sc)
 {
-    int i = xs->unscalarized_length() - 1;
+    int i = sc.indx;
     if (i > 0) {
-        double x = xs->realval(0);
-        double xp = xs->unscalarized_prev_real();
+        double x = sc.x;
+        double xp = sc.xprev;
         if (t_ptmode) {
             if (i < t_indx)
                 return (-1);
@@ -1498,6 +1567,19 @@ sRunopMeas::reset(sPlot *pl)
     ro_stop_flag        = false;
     ro_end_flag         = false;
     ro_queue_measure    = false;
+
+    ro_x[0]             = 0.0;
+    ro_x[1]             = 0.0;
+    ro_x[2]             = 0.0;
+    ro_xfirst           = 0.0;
+    ro_xs               = 0.0;
+    ro_npts             = -1;
+    ro_ipt             = -1;
+    ro_stream           = false;
+    for (sMfunc *ff = ro_funcs; ff; ff = ff->next())
+        ff->reset();
+    for (sMfunc *ff = ro_finds; ff; ff = ff->next())
+        ff->reset();
 }
 
 
@@ -1532,10 +1614,28 @@ sRunopMeas::check_measure(sRunDesc *run)
         // All non-param measurements done.
     }
     else {
-        if (!ro_start.check_found(circuit, &ro_measure_error, false))
+        // When the plot keeps only the current point (output to a
+        // file, or margin analysis), the measurement is accumulated
+        // as points arrive.
+        ro_stream = run->rd() ||
+            (run->check() && run->check()->out_mode == OutcCheck);
+
+        sMscale sc;
+        if (ro_stream) {
+            stream_point(circuit);
+            sc.x = ro_x[ro_npts%3];
+            sc.xprev = ro_npts > 0 ? ro_x[(ro_npts-1)%3] : sc.x;
+            sc.xfirst = ro_xfirst;
+            sc.indx = ro_npts;
+        }
+        else
+            sc.set(circuit->runplot()->scale());
+        if (!ro_start.check_found(circuit, &ro_measure_error, false, sc))
             ready = false;
-        if (!ro_end.check_found(circuit, &ro_measure_error, true))
+        if (!ro_end.check_found(circuit, &ro_measure_error, true, sc))
             ready = false;
+        if (ro_stream && !ro_measure_error)
+            stream_update();
     }
     ro_cktptr = circuit;
     ro_queue_measure = ready;
@@ -1557,7 +1657,11 @@ sRunopMeas::do_measure(sRunDesc *run)
 
     sDataVec *dv;
     int cnt;
-    if (!measure(&dv, &cnt))
+    if (ro_stream) {
+        if (!stream_measure(&dv, &cnt))
+            return (false);
+    }
+    else if (!measure(&dv, &cnt))
         return (false);
     if (!update_plot(dv, cnt))
         return (false);
@@ -1712,7 +1816,9 @@ sRunopMeas::measure(sDataVec **dvp, int *cntp)
                         ff->set_val(0);
                     else {
                         sDataVec *txs = ro_cktptr->runplot()->scale();
-                        ff->set_val(findpw(dv, txs));
+                        ff->set_val(findpw(dv, txs, ro_start.indx(),
+                            ro_end.indx(), startval(dv, txs),
+                            endval(dv, txs)));
                     }
                 }
                 else if (ff->type() == Mrft) {
@@ -1720,7 +1826,9 @@ sRunopMeas::measure(sDataVec **dvp, int *cntp)
                         ff->set_val(0);
                     else {
                         sDataVec *txs = ro_cktptr->runplot()->scale();
-                        ff->set_val(findrft(dv, txs));
+                        ff->set_val(findrft(dv, txs, ro_start.indx(),
+                            ro_end.indx(), startval(dv, txs),
+                            endval(dv, txs)));
                     }
                 }
             }
@@ -1774,6 +1882,274 @@ sRunopMeas::measure(sDataVec **dvp, int *cntp)
 }
 
 
+// The functions below implement measurement when the plot keeps
+// only the current point, as when writing output to a file.  The
+// scale and expression values for the last three points are kept, and
+// the interval measurements are accumulated as points arrive.  The
+// results are identical to those obtained from saved vectors.  Only
+// the pw and rft functions, which need two passes, buffer the values
+// within the measurement interval.
+
+namespace {
+    // Append a value to a buffer vector.
+    //
+    void push_val(sDataVec *v, double d)
+    {
+        int len = v->length();
+        if (len >= v->allocated())
+            v->resize(2*len + 16);
+        v->set_length(len + 1);
+        v->set_realval(len, d);
+    }
+}
+
+
+// Advance to the next point, saving the scale and expression values.
+//
+void
+sRunopMeas::stream_point(sFtCirc *circuit)
+{
+    sDataVec *xs = circuit->runplot()->scale();
+    ro_npts++;
+    double x = xs->realval(0);
+    if (ro_npts == 0)
+        ro_xfirst = x;
+    ro_x[ro_npts%3] = x;
+    if (ro_end.active()) {
+        for (sMfunc *ff = ro_funcs; ff; ff = ff->next())
+            ff->stream_eval(ro_npts);
+    }
+    for (sMfunc *ff = ro_finds; ff; ff = ff->next())
+        ff->stream_eval(ro_npts);
+}
+
+
+// Accumulate the interval measurements through the current point, or
+// through the end index if known.  When the start becomes ready its
+// index is never more than one point back, and the end index is never
+// less than the previous point, so the saved values suffice.
+//
+void
+sRunopMeas::stream_update()
+{
+    if (!ro_start.ready())
+        return;
+    int is = ro_start.indx();
+    if (ro_ipt < 0) {
+        // The start was just found, set up the accumulators.
+        if (!stream_val(0, is, &ro_xs)) {
+            ro_measure_error = true;
+            return;
+        }
+        double sf = ro_start.found();
+        double xp = 0.0;
+        bool interp = sf != ro_xs && is > 0 && stream_val(0, is-1, &xp);
+        for (int k = 0; k < 2; k++) {
+            sMfunc *f0 = k ? ro_finds : (ro_end.active() ? ro_funcs : 0);
+            for (sMfunc *ff = f0; ff; ff = ff->next()) {
+                if (ff->error())
+                    continue;
+                double y = 0.0;
+                stream_val(ff, is, &y);
+                double sv = y;
+                if (interp) {
+                    double yp = 0.0;
+                    stream_val(ff, is-1, &yp);
+                    sv = y + (yp - y)*(sf - ro_xs)/(xp - ro_xs);
+                }
+                ff->f_ys = y;
+                ff->f_sv = sv;
+                ff->f_min = y;
+                ff->f_max = y;
+                ff->f_sum = 0.0;
+                ff->f_sum2 = 0.0;
+                if (ff->type() == Mpw || ff->type() == Mrft) {
+                    delete ff->f_xbuf;
+                    ff->f_xbuf = new sDataVec;
+                    delete ff->f_ybuf;
+                    ff->f_ybuf = new sDataVec;
+                }
+            }
+        }
+        ro_ipt = is;
+    }
+    if (!ro_end.active())
+        return;
+
+    int ie = ro_npts;
+    if (ro_end.ready() && ro_end.indx() < ie)
+        ie = ro_end.indx();
+    for (int i = ro_ipt; i <= ie; i++) {
+        double x, xp = 0.0;
+        if (!stream_val(0, i, &x) || (i > is && !stream_val(0, i-1, &xp))) {
+            ro_measure_error = true;
+            return;
+        }
+        for (sMfunc *ff = ro_funcs; ff; ff = ff->next()) {
+            if (ff->error())
+                continue;
+            double y = 0.0;
+            stream_val(ff, i, &y);
+            if (i > is) {
+                double yp = 0.0;
+                stream_val(ff, i-1, &yp);
+                double delt = x - xp;
+                ff->f_sum += 0.5*delt*(yp + y);
+                ff->f_sum2 += 0.5*delt*(yp*yp + y*y);
+                if (y < ff->f_min)
+                    ff->f_min = y;
+                if (y > ff->f_max)
+                    ff->f_max = y;
+            }
+            if (ff->f_ybuf) {
+                push_val(ff->f_xbuf, x);
+                push_val(ff->f_ybuf, y);
+            }
+        }
+    }
+    if (ie >= ro_ipt)
+        ro_ipt = ie + 1;
+}
+
+
+// Set *pv to the value of ff at point i, or to the scale value if ff
+// is null.  False is returned if the point is no longer available.
+//
+bool
+sRunopMeas::stream_val(sMfunc *ff, int i, double *pv)
+{
+    if (i < 0 || i > ro_npts || i < ro_npts - 2)
+        return (false);
+    *pv = ff ? ff->f_y[i%3] : ro_x[i%3];
+    return (true);
+}
+
+
+// Compute the results from the accumulated values, this replaces
+// measure() when streaming.
+//
+bool
+sRunopMeas::stream_measure(sDataVec **dvp, int *cntp)
+{
+    if (dvp)
+        *dvp = 0;
+    if (cntp)
+        *cntp = 0;
+    if (!ro_cktptr || ro_ipt < 0)
+        return (false);
+    sDataVec *dv0 = 0;
+    int count = 0;
+    if (ro_start.ready() && ro_end.ready()) {
+        int ie = ro_end.indx();
+        double xe;
+        if (!stream_val(0, ie, &xe)) {
+            ro_measure_error = true;
+            return (false);
+        }
+        double sf = ro_start.found();
+        double ef = ro_end.found();
+        double xn = 0.0;
+        bool interp = ef != xe && stream_val(0, ie+1, &xn);
+        double dt = ef - sf;
+
+        for (int k = 0; k < 2; k++) {
+            sMfunc *f0 = k ? ro_finds : ro_funcs;
+            for (sMfunc *ff = f0; ff; ff = ff->next(), count++) {
+                double y = 0.0;
+                if (ff->error() || !stream_val(ff, ie, &y)) {
+                    ff->set_error(true);
+                    ff->set_val(0.0);
+                    continue;
+                }
+                double ev = y;
+                if (interp) {
+                    double yn = 0.0;
+                    stream_val(ff, ie+1, &yn);
+                    ev = y + (yn - y)*(ef - xe)/(xn - xe);
+                }
+                if (!dv0 && ff->f_tree)
+                    dv0 = Sp.Evaluate(ff->f_tree);
+
+                if (k) {
+                    // A find, the difference between end and start.
+                    ff->set_val(ev - ff->f_sv);
+                    continue;
+                }
+                double mn = SPMIN(ff->f_min, SPMIN(ff->f_sv, ev));
+                double mx = SPMAX(ff->f_max, SPMAX(ff->f_sv, ev));
+                if (ff->type() == Mmin)
+                    ff->set_val(mn);
+                else if (ff->type() == Mmax)
+                    ff->set_val(mx);
+                else if (ff->type() == Mpp)
+                    ff->set_val(mx - mn);
+                else if (ff->type() == Mavg) {
+                    double sum = ff->f_sum;
+                    double delt = ro_xs - sf;
+                    if (delt != 0.0)
+                        sum += 0.5*delt*(ff->f_sv + ff->f_ys);
+                    delt = ef - xe;
+                    if (delt != 0.0)
+                        sum += 0.5*delt*(ev + y);
+                    if (dt != 0.0)
+                        sum /= dt;
+                    ff->set_val(sum);
+                }
+                else if (ff->type() == Mrms) {
+                    double sum = ff->f_sum2;
+                    double delt = ro_xs - sf;
+                    if (delt != 0.0) {
+                        sum += 0.5*delt*(ff->f_sv*ff->f_sv +
+                            ff->f_ys*ff->f_ys);
+                    }
+                    delt = ef - xe;
+                    if (delt != 0.0)
+                        sum += 0.5*delt*(ev*ev + y*y);
+                    if (dt != 0.0)
+                        sum /= dt;
+                    ff->set_val(sqrt(fabs(sum)));
+                }
+                else if (ff->type() == Mpw || ff->type() == Mrft) {
+                    if (!ff->f_ybuf || ff->f_ybuf->length() == 0)
+                        ff->set_val(0.0);
+                    else if (ff->type() == Mpw) {
+                        ff->set_val(findpw(ff->f_ybuf, ff->f_xbuf, 0,
+                            ie - ro_start.indx(), ff->f_sv, ev));
+                    }
+                    else {
+                        ff->set_val(findrft(ff->f_ybuf, ff->f_xbuf, 0,
+                            ie - ro_start.indx(), ff->f_sv, ev));
+                    }
+                    delete ff->f_xbuf;
+                    ff->f_xbuf = 0;
+                    delete ff->f_ybuf;
+                    ff->f_ybuf = 0;
+                }
+            }
+        }
+    }
+    else if (ro_start.ready()) {
+        for (sMfunc *ff = ro_finds; ff; ff = ff->next(), count++) {
+            if (ff->error()) {
+                ff->set_val(0.0);
+                continue;
+            }
+            ff->set_val(ff->f_sv);
+            if (!dv0 && ff->f_tree)
+                dv0 = Sp.Evaluate(ff->f_tree);
+        }
+    }
+    else
+        return (false);
+
+    if (dvp)
+        *dvp = dv0;
+    if (cntp)
+        *cntp = count;
+    return (true);
+}
+
+
 // Add a vector containing the results to the plot.
 //
 bool
@@ -2152,16 +2528,20 @@ sRunopMeas::findrms(sDataVec *dv, sDataVec *xs)
 }
 
 
-// Find the fwhm of a pulse assumed to be contained in the interval.
+// Find the fwhm of a pulse assumed to be contained in the interval
+// between indices is and ie, ds and de are the interpolated values at
+// the interval end points.
+//
 double
-sRunopMeas::findpw(sDataVec *dv, sDataVec *xs)
+sRunopMeas::findpw(sDataVec *dv, sDataVec *xs, int is, int ie, double ds,
+    double de)
 {
     // find the max/min
-    double mx = dv->realval(ro_start.indx());
+    double mx = dv->realval(is);
     double mn = mx;
     int imx = -1;
     int imn = -1;
-    for (int i = ro_start.indx()+1; i <= ro_end.indx(); i++) {
+    for (int i = is+1; i <= ie; i++) {
         if (dv->realval(i) > mx) {
             mx = dv->realval(i);
             imx = i;
@@ -2171,8 +2551,6 @@ sRunopMeas::findpw(sDataVec *dv, sDataVec *xs)
             imn = i;
         }
     }
-    double ds = startval(dv, xs);
-    double de = endval(dv, xs);
     double mid;
     int imid;
     if (mx - SPMAX(ds, de) > SPMIN(ds, de) - mn) {
@@ -2185,7 +2563,7 @@ sRunopMeas::findpw(sDataVec *dv, sDataVec *xs)
     }
 
     int ibeg = -1, iend = -1;
-    for (int i = ro_start.indx() + 1; i <= ro_end.indx(); i++) {
+    for (int i = is + 1; i <= ie; i++) {
         if ((dv->realval(i-1) < mid && dv->realval(i) >= mid) ||
                 (dv->realval(i-1) > mid && dv->realval(i) <= mid)) {
             if (ibeg >= 0)
@@ -2214,18 +2592,18 @@ sRunopMeas::findpw(sDataVec *dv, sDataVec *xs)
 
 
 // Find the 10-90% rise or fall time of an edge contained in the
-// interval.
+// interval between indices is and ie, vstart and vend are the
+// interpolated values at the interval end points.
 //
 double
-sRunopMeas::findrft(sDataVec *dv, sDataVec *xs)
+sRunopMeas::findrft(sDataVec *dv, sDataVec *xs, int is, int ie,
+    double vstart, double vend)
 {
-    double vstart = startval(dv, xs);
-    double vend = endval(dv, xs);
     double th1 = vstart + 0.1*(vend - vstart);
     double th2 = vstart + 0.9*(vend - vstart);
 
     int ibeg = -1, iend = -1;
-    for (int i = ro_start.indx() + 1; i <= ro_end.indx(); i++) {
+    for (int i = is + 1; i <= ie; i++) {
         if ((dv->realval(i-1) < th1 && dv->realval(i) >= th1) ||
                 (dv->realval(i-1) > th1 && dv->realval(i) <= th1) ||
                 (dv->realval(i-1) < th2 && dv->realval(i) >= th2) ||
@@ -2372,7 +2750,9 @@ sRunopStop::check_stop(sRunDesc *run)
         return (RO_OK);
 
     sFtCirc *circuit = run->circuit();
-    if (!ro_start.check_found(circuit, &ro_stop_error, false))
+    sMscale sc;
+    sc.set(circuit->runplot()->scale());
+    if (!ro_start.check_found(circuit, &ro_stop_error, false, sc))
         return (RO_OK);
 
     // Execute command if any.
@@ -630,7 +630,9 @@ IFoutput::appendData(sRunDesc *run, IFvalue *refValue, IFvalue *valuePtr)
 
 
 // Write data for one point to the saved vectors at the given index.
-// The vectors will be expanded as necessary to include the index.
+// The vectors will be expanded as necessary to include the index. 
+// This is called from analysis threads writing to a shared plot, so
+// calls are serialized.
 //
 int
 IFoutput::insertData(sCKT *ckt, sRunDesc *run, IFvalue *refValue,
@@ -664,6 +666,10 @@ IFoutput::insertData(sCKT *ckt, sRunDesc *run, IFvalue *refValue,
     }
     */
 
+#ifdef WITH_THREADS
+    pthread_mutex_lock(&sCKT::CKTdumpLock);
+#endif
+
     // The run circuit was set in beginPlot and is the primary thread
     // ciruit.  We need that actual thread circuit here.
     run->pushPointToPlot(ckt, refValue, valuePtr, indx);
@@ -710,10 +716,24 @@ IFoutput::insertData(sCKT *ckt, sRunDesc *run, IFvalue *refValue,
     */
 
     vecGc();
+#ifdef WITH_THREADS
+    pthread_mutex_unlock(&sCKT::CKTdumpLock);
+#endif
     return (OK);
 }
 
 
+// Return true if data for the run can be saved out of order with
+// insertData, which requires that the data are kept in memory and
+// are not part of a margin analysis.
+//
+bool
+IFoutput::canInsert(sRunDesc *run)
+{
+    return (run && !run->rd() && !run->check());
+}
+
+
 // Modify the plot dimensionality.
 //
 int
@@ -55,6 +55,13 @@ Authors: 1986 Wayne A. Christopher
 #include "spnumber/hash.h"
 #include "ginterf/graphics.h"
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 
 //
 // Read and write the ascii and binary rawfile formats.
@@ -66,6 +73,8 @@ cRawOut::cRawOut(sPlot *pl)
 {
     ro_plot = pl;
     ro_fp = 0;
+    ro_buf = 0;
+    ro_bufcnt = 0;
     ro_pointPosn = 0;
     ro_prec = 0;
     ro_numdims = 0;
@@ -83,6 +92,7 @@ cRawOut::cRawOut(sPlot *pl)
 cRawOut::~cRawOut()
 {
     file_close();
+    delete [] ro_buf;
 }
 
 
@@ -143,6 +153,8 @@ cRawOut::file_open(const char *filename, const char *mode, bool binary)
     ro_length = 0;
     ro_realflag = true;
     ro_binary = binary;
+    if (binary && !ro_buf)
+        ro_buf = new double[RAW_BUFSIZE];
 
     bool nopadding = Sp.GetVar(kw_nopadding, VTYP_BOOL, 0);
     ro_pad = !nopadding;
@@ -320,33 +332,22 @@ cRawOut::file_points(int indx)
                 sDataVec *v = dl->dl_dvec;
                 if (v) {
                     // Don't run off the end of this vector's data
-                    double dd;
                     if (i < v->length()) {
-                        if (ro_realflag) {
-                            dd = v->realval(i);
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
-                        }
+                        if (ro_realflag)
+                            put_val(v->realval(i));
                         else if (v->isreal()) {
-                            dd = v->realval(i);
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
-                            dd = 0.0;
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
+                            put_val(v->realval(i));
+                            put_val(0.0);
                         }
                         else {
-                            dd = v->realval(i);
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
-                            dd = v->imagval(i);
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
+                            put_val(v->realval(i));
+                            put_val(v->imagval(i));
                         }
                     }
                     else if (ro_pad) {
-                        dd = 0.0;
-                        if (ro_realflag)
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
-                        else {
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
-                            fwrite((char*)&dd, sizeof(double), 1, ro_fp);
-                        }
+                        put_val(0.0);
+                        if (!ro_realflag)
+                            put_val(0.0);
                     }
                 }
             }
@@ -390,6 +391,8 @@ cRawOut::file_points(int indx)
 bool
 cRawOut::file_update_pcnt(int pointCount)
 {
+    if (!flush_buf())
+        return (false);
     if (!ro_fp || ro_fp == stdout)
         return (true);
     fflush(ro_fp);
@@ -407,11 +410,32 @@ cRawOut::file_update_pcnt(int pointCount)
 bool
 cRawOut::file_close()
 {
+    bool ret = flush_buf();
     sDvList::destroy(ro_dlist);
     ro_dlist = 0;
     if (ro_fp && ro_fp != stdout && !ro_no_close)
         fclose(ro_fp);
     ro_fp = 0;
+    return (ret);
+}
+
+
+// Write out the buffered binary data.  The buffer holds many points
+// for a large plot, so this replaces a great many small writes.
+//
+bool
+cRawOut::flush_buf()
+{
+    if (!ro_bufcnt)
+        return (true);
+    unsigned int n = ro_bufcnt;
+    ro_bufcnt = 0;
+    if (!ro_fp)
+        return (true);
+    if (fwrite(ro_buf, sizeof(double), n, ro_fp) != n) {
+        GRpkgIf()->Perror("rawfile write");
+        return (false);
+    }
     return (true);
 }
 // End of cRawOut functions.
@@ -542,7 +566,6 @@ cRawIn::raw_read(const char *name)
                 else
                     GRpkgIf()->ErrPrintf(ET_WARN, "unknown flag %s.\n", buf2);
             }
-            (void)raw_padded;  // unused
         }
         else if (lstring::ciprefix("no. variables:", buf)) {
             char *s = buf;
@@ -778,7 +801,10 @@ cRawIn::raw_read(const char *name)
                     }
                 }
             }
-            read_data((*buf == 'v' || *buf == 'V') ? false : true, curpl);
+            bool isbin = (*buf == 'v' || *buf == 'V') ? false : true;
+            if (!isbin || !raw_padded || npoints <= 0 ||
+                    read_mapped(curpl, npoints) < npoints)
+                read_data(isbin, curpl);
         }
         else {
             char *s = buf;
@@ -900,11 +926,92 @@ cRawIn::read_data(bool isbin, sPlot *curpl)
 }
 
 
+// Read the data of a padded binary plot with a known point count, by
+// mapping the file and copying the values straight into the vectors. 
+// The file is left positioned after the data, so that another plot
+// can follow.  The return is the number of points read, which will
+// be less than npoints if the file is truncated, or -1 if the file
+// can't be mapped, in which case the caller reads the data with
+// stdio.
+//
+int
+cRawIn::read_mapped(sPlot *curpl, int npoints)
+{
+#ifdef WIN32
+    (void)curpl;
+    (void)npoints;
+    return (-1);
+#else
+    struct stat st;
+    int fd = fileno(ri_fp);
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode))
+        return (-1);
+    off_t offs = ftell(ri_fp);
+    if (offs < 0 || offs >= st.st_size)
+        return (-1);
+
+    size_t rowsize = 0;
+    for (sDataVec *v = curpl->tempvecs(); v; v = v->next())
+        rowsize += v->isreal() ? sizeof(double) : 2*sizeof(double);
+    if (!rowsize)
+        return (-1);
+    size_t nrows = (st.st_size - offs)/rowsize;
+    if (nrows > (size_t)npoints)
+        nrows = npoints;
+    if (!nrows)
+        return (-1);
+
+    // The map offset must be page aligned.
+    off_t base = offs - offs % sysconf(_SC_PAGESIZE);
+    size_t len = (offs - base) + nrows*rowsize;
+    void *addr = mmap(0, len, PROT_READ, MAP_PRIVATE, fd, base);
+    if (addr == MAP_FAILED)
+        return (-1);
+#ifdef MADV_SEQUENTIAL
+    madvise(addr, len, MADV_SEQUENTIAL);
+#endif
+
+    // The values are not necessarily aligned in the map, so they are
+    // copied with memcpy.
+    const char *data = (const char*)addr + (offs - base);
+    size_t col = 0;
+    for (sDataVec *v = curpl->tempvecs(); v; v = v->next()) {
+        if (v->allocated() < (int)nrows)
+            v->resize(nrows);
+        const char *p = data + col;
+        if (v->isreal()) {
+            double *d = v->realvec();
+            for (size_t i = 0; i < nrows; i++) {
+                memcpy(d + i, p, sizeof(double));
+                p += rowsize;
+            }
+            col += sizeof(double);
+        }
+        else {
+            complex *c = v->compvec();
+            for (size_t i = 0; i < nrows; i++) {
+                memcpy(&c[i].real, p, sizeof(double));
+                memcpy(&c[i].imag, p + sizeof(double), sizeof(double));
+                p += rowsize;
+            }
+            col += 2*sizeof(double);
+        }
+        v->set_length(nrows);
+    }
+    munmap(addr, len);
+    fseek(ri_fp, offs + nrows*rowsize, SEEK_SET);
+    return (nrows);
+#endif
+}
+
+
 void
 cRawIn::add_point(sDataVec *v, double *val1, double *val2)
 {
-    if (v->length() >= v->allocated())
-        v->resize(v->length() + SIZE_INCR);
+    if (v->length() >= v->allocated()) {
+        // Grow geometrically, the point count is not known.
+        v->resize(v->length() + SIZE_INCR + v->length()/2);
+    }
     if (v->isreal())
         v->set_realval(v->length(), *val1);
     else {
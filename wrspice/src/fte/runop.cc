@@ -704,10 +704,8 @@ IFoutput::checkRunops(sRunDesc *run, double ref)
         for (sRunopTrace *d = tgen.next(); d; d = tgen.next())
             d->print_trace(run->runPlot(), &tflag, run->pointsSeen());
 
-/*XXX handle these somehow?
-// can't do actual measurements since we don't have data, but
-// process call/print and, maybe create new vector with expression
-// result.
+        // The measurements are accumulated as points arrive, since
+        // there is no saved data.
         bool measures_done = true;
         bool measure_queued = false;
         ROgen<sRunopMeas> mgen(o_runops->measures(), db ? db->measures() : 0);
@@ -745,6 +743,7 @@ IFoutput::checkRunops(sRunDesc *run, double ref)
             }
         }
 
+/*XXX handle these somehow?
         ROgen<sRunopStop> sgen(o_runops->stops(), db ? db->stops() : 0);
         for (sRunopStop *d = sgen.next(); d; d = sgen.next())
             ROret r = d->check_stop(run);
@@ -100,6 +100,48 @@ private:
 
 // Subcircuit object
 //
+// List element for calls that provide no instance parameters.  The
+// parameter table depends only on the calling context, which is
+// identified by pc_parent, and so does the body after nested calls
+// are expanded.  The body is kept as a template from the second call
+// on, and each instance is stamped from it by translation, which
+// applies the node map and instance name.
+//
+struct sScPctx
+{
+    sScPctx(int p, int i, sParamTab *t, sScPctx *n)
+        {
+            pc_next = n;
+            pc_tab = t;
+            pc_body = 0;
+            pc_parent = p;
+            pc_id = i;
+            pc_calls = 0;
+        }
+
+    ~sScPctx()
+        {
+            delete pc_tab;
+            sLine::destroy(pc_body);
+        }
+
+    static void destroy(sScPctx *p)
+        {
+            while (p) {
+                sScPctx *px = p;
+                p = p->pc_next;
+                delete px;
+            }
+        }
+
+    sScPctx *pc_next;
+    sParamTab *pc_tab;      // Merged parameter table.
+    sLine *pc_body;         // Expanded body template, untranslated.
+    int pc_parent;          // Id of calling context.
+    int pc_id;              // Id of this context.
+    int pc_calls;           // Number of expansions done.
+};
+
 struct sSubc
 {
     sSubc()
@@ -109,6 +151,7 @@ struct sSubc
             su_numargs = 0;
             su_params = 0;
             su_body = 0;
+            su_pctx = 0;
         }
 
     sSubc(sLine*);
@@ -123,6 +166,7 @@ struct sSubc
     int su_numargs;         // The argument count.
     sParamTab *su_params;   // Name = Value parameter list.
     sLine *su_body;         // The deck that is to be substituted.
+    sScPctx *su_pctx;       // Shared contexts, not copied.
 };
 
 // Hash table for sSubc objects.
@@ -162,11 +206,12 @@ struct sMods
 //
 struct sSCX
 {
-    sSCX() { mods = 0; subs = 0; }
+    sSCX() { mods = 0; subs = 0; ptid = 0; }
     void clear() { mods = 0; subs = 0; }
 
     sMods *mods;
     sSubcTab *subs;
+    int ptid;               // Parameter context id, -1 if not shared.
 };
 
 
@@ -179,6 +224,7 @@ struct sScGlobal
             sg_stack_ptr = 0;
             sg_glob_tab = 0;
             sg_submaps = 0;
+            sg_ptid_cnt = 0;
             memset(sg_stack, 0, SUB_STK_DEPTH*sizeof(sSCX));
         }
 
@@ -235,6 +281,7 @@ struct sScGlobal
 
 private:
     int sg_stack_ptr;
+    int sg_ptid_cnt;                // Parameter context id generator.
 
     sHtab *sg_glob_tab;             // Global nodename table.
 
@@ -539,12 +586,27 @@ sScGlobal::expand_and_replace(sLine *deck, sParamTab **parm_ptr,
             continue;
         }
 
-        // Now we have to replace this card with the macro definition.
-        //
-        sLine *lcc = sLine::copy(sss->su_body);
+        // A call with no instance parameters gets the same table in
+        // every instance that shares the calling context, so build it
+        // once and keep it in the subcircuit.  Contexts are
+        // identified by id rather than table address, since
+        // addresses are recycled as tables come and go.  The
+        // top-level context has id 0, unshared contexts have -1.
+
+        int ptid = sg_stack[sg_stack_ptr].ptid;
+        bool shared = (ptid >= 0 && (!params || !*params));
+        sScPctx *pctx = 0;
+        if (shared) {
+            for (pctx = sss->su_pctx; pctx; pctx = pctx->pc_next) {
+                if (pctx->pc_parent == ptid)
+                    break;
+            }
+        }
 
         sParamTab *ptab = 0;
-        if (SPcx.parhier() == ParHierGlobal) {
+        if (pctx)
+            ptab = pctx->pc_tab;
+        else if (SPcx.parhier() == ParHierGlobal) {
             // The "parhier" option is set to "global". 
             // Above-scope parameter assignments override
             // lower assignments.
@@ -575,11 +637,31 @@ sScGlobal::expand_and_replace(sLine *deck, sParamTab **parm_ptr,
             delete [] sParamTab::errString;
             sParamTab::errString = 0;
         }
+        if (shared && !pctx && ptab) {
+            pctx = new sScPctx(ptid, ++sg_ptid_cnt, ptab, sss->su_pctx);
+            sss->su_pctx = pctx;
+        }
+
+        // Now we have to replace this card with the macro definition. 
+        // In a shared context, the expanded body is the same for
+        // every call, so it is saved after the second expansion and
+        // copied after that.  Cells called once are not saved.
+        //
+        sLine *lcc;
+        if (pctx && pctx->pc_body)
+            lcc = sLine::copy(pctx->pc_body);
+        else {
+            lcc = sLine::copy(sss->su_body);
+
+            // Location of these lines changed in 3.2.18 to fix nesting.
+            sg_stack_ptr++;
+            sg_stack[sg_stack_ptr].ptid = pctx ? pctx->pc_id : -1;
+            lcc = expand_and_replace(lcc, &ptab, udf_ptr);
+            sg_stack_ptr--;
 
-        // Location of these lines changed in 3.2.18 to fix nesting.
-        sg_stack_ptr++;
-        lcc = expand_and_replace(lcc, &ptab, udf_ptr);
-        sg_stack_ptr--;
+            if (pctx && lcc && ++pctx->pc_calls > 1)
+                pctx->pc_body = sLine::copy(lcc);
+        }
 
 #ifdef TIME_DBG
         double ts_tr == OP.seconds();
@@ -596,7 +678,8 @@ sScGlobal::expand_and_replace(sLine *deck, sParamTab **parm_ptr,
         delete [] params;
 
         ptab->undefine_macros();
-        delete ptab;
+        if (!pctx)
+            delete ptab;
 
 #ifdef TIME_DBG
         double te_tr = OP.seconds();
@@ -2276,6 +2359,7 @@ sSubc::~sSubc()
     delete [] su_args;
     delete su_params;
     sLine::destroy(su_body);
+    sScPctx::destroy(su_pctx);
 }
 
 
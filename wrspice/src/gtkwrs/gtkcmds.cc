@@ -322,6 +322,18 @@ GTKtoolbar::PopUpCmdConfig(int x, int y)
             (GtkAttachOptions)0, 2, 2);
     }
 
+    entry = KWGET(kw_checkjobs);
+    if (entry) {
+        entry->ent = new xEnt(kw_int_func);
+        entry->ent->setup(DEF_checkjobs, 1.0, 0.0, 0.0, 0);
+        entry->ent->create_widgets(entry, STRINGIFY(DEF_checkjobs));
+
+        gtk_table_attach(GTK_TABLE(form), entry->ent->frame, 1, 2,
+            entrycount, entrycount + 1,
+            (GtkAttachOptions)(GTK_EXPAND | GTK_FILL | GTK_SHRINK),
+            (GtkAttachOptions)0, 2, 2);
+    }
+
     entrycount++;
     entry = KWGET(kw_mplot_cur);
     if (entry) {
@@ -225,6 +225,16 @@ GTKtoolbar::PopUpSimDefs(int x, int y)
             (GtkAttachOptions)(GTK_EXPAND | GTK_FILL | GTK_SHRINK),
             (GtkAttachOptions)0, 2, 2);
     }
+    entry = KWGET(spkw_loadbypass);
+    if (entry) {
+        entry->ent = new xEnt(kw_bool_func);
+        entry->ent->create_widgets(entry, 0);
+
+        gtk_table_attach(GTK_TABLE(form), entry->ent->frame, 3, 4,
+            entrycount, entrycount + 1,
+            (GtkAttachOptions)(GTK_EXPAND | GTK_FILL | GTK_SHRINK),
+            (GtkAttachOptions)0, 2, 2);
+    }
 
     entrycount++;
     entry = KWGET(spkw_loadthrds);
@@ -249,6 +259,16 @@ GTKtoolbar::PopUpSimDefs(int x, int y)
             (GtkAttachOptions)(GTK_EXPAND | GTK_FILL | GTK_SHRINK),
             (GtkAttachOptions)0, 2, 2);
     }
+    entry = KWGET(spkw_loadbufs);
+    if (entry) {
+        entry->ent = new xEnt(kw_bool_func);
+        entry->ent->create_widgets(entry, 0);
+
+        gtk_table_attach(GTK_TABLE(form), entry->ent->frame, 2, 3,
+            entrycount, entrycount + 1,
+            (GtkAttachOptions)(GTK_EXPAND | GTK_FILL | GTK_SHRINK),
+            (GtkAttachOptions)0, 2, 2);
+    }
 
     char tbuf[64];
     //
@@ -0,0 +1,462 @@
+
+/*========================================================================*
+ *                                                                        *
+ *  Distributed by Whiteley Research Inc., Sunnyvale, California, USA     *
+ *                       http://wrcad.com                                 *
+ *  Copyright (C) 2017 Whiteley Research Inc., all rights reserved.       *
+ *  Author: Stephen R. Whiteley, except as indicated.                     *
+ *                                                                        *
+ *  As fully as possible recognizing licensing terms and conditions       *
+ *  imposed by earlier work from which this work was derived, if any,     *
+ *  this work is released under the Apache License, Version 2.0 (the      *
+ *  "License").  You may not use this file except in compliance with      *
+ *  the License, and compliance with inherited licenses which are         *
+ *  specified in a sub-header below this one if applicable.  A copy       *
+ *  of the License is provided with this distribution, or you may         *
+ *  obtain a copy of the License at                                       *
+ *                                                                        *
+ *        http://www.apache.org/licenses/LICENSE-2.0                      *
+ *                                                                        *
+ *  See the License for the specific language governing permissions       *
+ *  and limitations under the License.                                    *
+ *                                                                        *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,      *
+ *   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES      *
+ *   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-        *
+ *   INFRINGEMENT.  IN NO EVENT SHALL WHITELEY RESEARCH INCORPORATED      *
+ *   OR STEPHEN R. WHITELEY BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER     *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,      *
+ *   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE       *
+ *   USE OR OTHER DEALINGS IN THE SOFTWARE.                               *
+ *                                                                        *
+ *========================================================================*
+ *               XicTools Integrated Circuit Design System                *
+ *                                                                        *
+ * WRspice Circuit Simulation and Analysis Tool                           *
+ *                                                                        *
+ *========================================================================*
+ $Id:$
+ *========================================================================*/
+
+#include "config.h"
+#ifdef HAVE_ALLOCA_H
+#include <alloca.h>
+#endif
+#include "input.h"
+#include "inpptree.h"
+#include "circuit.h"
+
+
+//
+// Compilation of parse trees into a linear instruction tape.
+//
+// Tree evaluation visits every node through a member function
+// pointer, and the derivative trees repeat most of the work done for
+// the value.  Here, the value tree and the derivative trees are
+// lowered into a single list of instructions in evaluation order. 
+// Each instruction writes its own register, so a subexpression that
+// appears more than once, in the value or any derivative, is
+// computed once.  Subexpressions with constant operands are computed
+// at compile time, and instructions not needed for the results are
+// dropped.
+//
+
+namespace {
+    // True if d is neither infinite nor nan.
+    inline bool finite_val(double d)
+    {
+        return (d - d == 0.0);
+    }
+
+
+    // Apply a pure operation to operand values.
+    inline double apply(const PTinstr *in, double x, double y)
+    {
+        double t[2];
+        IFparseNode *p;
+        switch (in->op) {
+        case PTI_PLUS:
+            return (x + y);
+        case PTI_MINUS:
+            return (x - y);
+        case PTI_TIMES:
+            return (x * y);
+        case PTI_UMINUS:
+            return (-x);
+        }
+        t[0] = x;
+        t[1] = y;
+        p = in->u.node;
+        return (PTtape::call(p, t));
+    }
+
+
+    inline bool has_a(int op)
+    {
+        return (op != PTI_CONST && op != PTI_VAR && op != PTI_NODE);
+    }
+
+
+    inline bool has_b(int op)
+    {
+        return (op == PTI_PLUS || op == PTI_MINUS || op == PTI_TIMES ||
+            op == PTI_FUNC2);
+    }
+}
+
+
+// Tape construction state.
+//
+struct PTtapeBld
+{
+    PTtapeBld()
+        {
+            instrs = 0;
+            ninstrs = 0;
+            size = 0;
+            htab = 0;
+            hsize = 0;
+            failed = false;
+        }
+
+    ~PTtapeBld()
+        {
+            delete [] instrs;
+            delete [] htab;
+        }
+
+    int compile(IFparseNode*);
+    int emit(PTinstr&);
+
+private:
+    static unsigned int hash(const PTinstr&);
+    static bool same(const PTinstr&, const PTinstr&);
+    void rehash();
+
+public:
+    PTinstr *instrs;        // instructions emitted
+    int ninstrs;            // number of instructions
+    int size;               // size of instrs array
+    int *htab;              // CSE table, instruction index + 1
+    unsigned int hsize;     // size of htab, power of 2
+    bool failed;            // tree can't be compiled
+};
+
+
+// Return the register holding the value of the subtree p, or -1
+// on error.
+//
+int
+PTtapeBld::compile(IFparseNode *p)
+{
+    if (!p)
+        failed = true;
+    if (failed)
+        return (-1);
+    PTinstr in;
+    memset(&in, 0, sizeof(PTinstr));
+    in.a = -1;
+    in.b = -1;
+
+    if (p->p_evfunc == &IFparseNode::p_const) {
+        in.op = PTI_CONST;
+        in.u.constant = p->v.constant;
+    }
+    else if (p->p_evfunc == &IFparseNode::p_var) {
+        in.op = PTI_VAR;
+        in.u.index = p->p_valindx;
+    }
+    else if (p->p_evfunc == &IFparseNode::p_op) {
+        switch (p->p_type) {
+        case PT_PLUS:
+            in.op = PTI_PLUS;
+            break;
+        case PT_MINUS:
+            in.op = PTI_MINUS;
+            break;
+        case PT_TIMES:
+            in.op = PTI_TIMES;
+            break;
+        case PT_DIVIDE:
+        case PT_POWER:
+            // These have special cases, use the node function.
+            in.op = PTI_FUNC2;
+            in.fidx = -p->p_type;
+            in.u.node = p;
+            break;
+        default:
+            // A misplaced comma, the tree evaluator will report
+            // this.
+            failed = true;
+            return (-1);
+        }
+        in.a = compile(p->p_left);
+        in.b = compile(p->p_right);
+    }
+    else if (p->p_evfunc == &IFparseNode::p_fcn &&
+            p->p_type == PT_FUNCTION) {
+        if (p->p_left->p_type == PT_COMMA) {
+            if (!p->p_two_args(p->p_valindx) ||
+                    p->p_left->p_right->p_type == PT_COMMA) {
+                failed = true;
+                return (-1);
+            }
+            in.op = PTI_FUNC2;
+            in.a = compile(p->p_left->p_left);
+            in.b = compile(p->p_left->p_right);
+        }
+        else {
+            in.op = p->p_valindx == PTF_UMINUS ? PTI_UMINUS : PTI_FUNC1;
+            in.a = compile(p->p_left);
+        }
+        in.fidx = p->p_valindx;
+        in.u.node = p;
+    }
+    else {
+        // Anything else is evaluated by the node, and is not
+        // shared or folded.
+        in.op = PTI_NODE;
+        in.u.node = p;
+    }
+    if (failed)
+        return (-1);
+    return (emit(in));
+}
+
+
+// Add the instruction, or return the index of an identical
+// instruction already added.
+//
+int
+PTtapeBld::emit(PTinstr &in)
+{
+    if (has_a(in.op) && instrs[in.a].op == PTI_CONST &&
+            (!has_b(in.op) || instrs[in.b].op == PTI_CONST)) {
+        double d = apply(&in, instrs[in.a].u.constant,
+            has_b(in.op) ? instrs[in.b].u.constant : 0.0);
+        if (finite_val(d)) {
+            memset(&in, 0, sizeof(PTinstr));
+            in.op = PTI_CONST;
+            in.a = -1;
+            in.b = -1;
+            in.u.constant = d;
+        }
+    }
+
+    if (2*(unsigned int)(ninstrs + 1) > hsize)
+        rehash();
+    unsigned int mask = hsize - 1;
+    unsigned int h = hash(in) & mask;
+    while (htab[h]) {
+        int ix = htab[h] - 1;
+        if (same(instrs[ix], in))
+            return (ix);
+        h = (h + 1) & mask;
+    }
+
+    if (ninstrs == size) {
+        int nsz = size ? 2*size : 64;
+        PTinstr *tmp = new PTinstr[nsz];
+        if (ninstrs)
+            memcpy(tmp, instrs, ninstrs*sizeof(PTinstr));
+        delete [] instrs;
+        instrs = tmp;
+        size = nsz;
+    }
+    instrs[ninstrs] = in;
+    htab[h] = ninstrs + 1;
+    return (ninstrs++);
+}
+
+
+unsigned int
+PTtapeBld::hash(const PTinstr &in)
+{
+    unsigned int h = in.op;
+    h = h*31 + in.fidx;
+    h = h*31 + in.a;
+    h = h*31 + in.b;
+    if (in.op == PTI_CONST) {
+        unsigned int w[sizeof(double)/sizeof(unsigned int)];
+        memcpy(w, &in.u.constant, sizeof(double));
+        for (unsigned int i = 0; i < sizeof(double)/sizeof(unsigned int);
+                i++)
+            h = h*31 + w[i];
+    }
+    else if (in.op == PTI_VAR)
+        h = h*31 + in.u.index;
+    else if (in.op == PTI_NODE)
+        h = h*31 + (unsigned int)(unsigned long)in.u.node;
+    return (h ^ (h >> 16));
+}
+
+
+bool
+PTtapeBld::same(const PTinstr &x, const PTinstr &y)
+{
+    if (x.op != y.op || x.fidx != y.fidx || x.a != y.a || x.b != y.b)
+        return (false);
+    if (x.op == PTI_CONST)
+        return (!memcmp(&x.u.constant, &y.u.constant, sizeof(double)));
+    if (x.op == PTI_VAR)
+        return (x.u.index == y.u.index);
+    if (x.op == PTI_NODE)
+        return (x.u.node == y.u.node);
+    // Functions and operations are identified by op and fidx.
+    return (true);
+}
+
+
+void
+PTtapeBld::rehash()
+{
+    unsigned int nsz = hsize ? 2*hsize : 128;
+    while (nsz < 2*(unsigned int)(ninstrs + 1))
+        nsz <<= 1;
+    delete [] htab;
+    htab = new int[nsz];
+    memset(htab, 0, nsz*sizeof(int));
+    hsize = nsz;
+    unsigned int mask = hsize - 1;
+    for (int i = 0; i < ninstrs; i++) {
+        unsigned int h = hash(instrs[i]) & mask;
+        while (htab[h])
+            h = (h + 1) & mask;
+        htab[h] = i + 1;
+    }
+}
+
+
+// Static function.
+// Compile the tree, and the nd derivative trees if derivs is not
+// null, into a new tape.  Null is returned if the tree contains an
+// error, the tree evaluator should be used in that case.
+//
+PTtape *
+PTtape::compile(IFparseNode *tree, IFparseNode **derivs, int nd)
+{
+    if (!tree)
+        return (0);
+    if (!derivs)
+        nd = 0;
+    PTtapeBld bld;
+    int *outs = new int[nd + 1];
+    outs[0] = bld.compile(tree);
+    int nval = bld.ninstrs;
+    for (int i = 0; i < nd; i++)
+        outs[i+1] = bld.compile(derivs[i]);
+    if (bld.failed) {
+        delete [] outs;
+        return (0);
+    }
+
+    // Drop the instructions not used for a result, these are mostly
+    // the operands of folded constants.
+    char *live = new char[bld.ninstrs];
+    memset(live, 0, bld.ninstrs);
+    for (int i = 0; i <= nd; i++)
+        live[outs[i]] = 1;
+    for (int i = bld.ninstrs - 1; i >= 0; i--) {
+        if (!live[i])
+            continue;
+        const PTinstr &in = bld.instrs[i];
+        if (has_a(in.op))
+            live[in.a] = 1;
+        if (has_b(in.op))
+            live[in.b] = 1;
+    }
+    int *map = new int[bld.ninstrs];
+    PTtape *tape = new PTtape;
+    tape->t_instrs = new PTinstr[bld.ninstrs];
+    int n = 0;
+    for (int i = 0; i < bld.ninstrs; i++) {
+        if (i == nval)
+            tape->t_nval = n;
+        if (!live[i])
+            continue;
+        PTinstr &in = tape->t_instrs[n];
+        in = bld.instrs[i];
+        if (has_a(in.op))
+            in.a = map[in.a];
+        if (has_b(in.op))
+            in.b = map[in.b];
+        map[i] = n++;
+    }
+    if (nval == bld.ninstrs)
+        tape->t_nval = n;
+    tape->t_ninstrs = n;
+    tape->t_noutputs = nd + 1;
+    tape->t_outputs = outs;
+    for (int i = 0; i <= nd; i++)
+        outs[i] = map[outs[i]];
+    delete [] map;
+    delete [] live;
+    return (tape);
+}
+
+
+// Evaluate the tape, with the circuit variables in vals.  The value
+// is returned in result, and the derivatives in dvs if not null, in
+// which case the tape must have been compiled with the derivatives. 
+// Only the instructions needed for the value are run if dvs is null.
+//
+int
+PTtape::eval(double *result, double *dvs, const double *vals) const
+{
+    int n = dvs ? t_ninstrs : t_nval;
+    double *r = (double*)alloca((n + 1)*sizeof(double));
+    const PTinstr *in = t_instrs;
+    for (int i = 0; i < n; i++, in++) {
+        switch (in->op) {
+        case PTI_CONST:
+            r[i] = in->u.constant;
+            break;
+        case PTI_VAR:
+            r[i] = vals[in->u.index];
+            break;
+        case PTI_PLUS:
+            r[i] = r[in->a] + r[in->b];
+            break;
+        case PTI_MINUS:
+            r[i] = r[in->a] - r[in->b];
+            break;
+        case PTI_TIMES:
+            r[i] = r[in->a] * r[in->b];
+            break;
+        case PTI_UMINUS:
+            r[i] = -r[in->a];
+            break;
+        case PTI_FUNC1:
+            {
+                double t[2];
+                t[0] = r[in->a];
+                t[1] = 0.0;
+                r[i] = call(in->u.node, t);
+            }
+            break;
+        case PTI_FUNC2:
+            {
+                double t[2];
+                t[0] = r[in->a];
+                t[1] = r[in->b];
+                r[i] = call(in->u.node, t);
+            }
+            break;
+        case PTI_NODE:
+            {
+                IFparseNode *p = in->u.node;
+                int err = (p->*p->p_evfunc)(r + i, vals, 0);
+                if (err != OK)
+                    return (err);
+            }
+            break;
+        }
+    }
+    *result = r[t_outputs[0]];
+    if (dvs) {
+        for (int i = 1; i < t_noutputs; i++)
+            dvs[i-1] = r[t_outputs[i]];
+    }
+    return (OK);
+}
+// End of PTtape functions.
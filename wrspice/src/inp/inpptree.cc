@@ -141,6 +141,7 @@ IFparseTree::IFparseTree(sCKT *ct, const char *xa)
     pt_vars = 0;
     pt_xalias = lstring::copy(xa);
     pt_xtree = 0;
+    pt_tape = 0;
     pt_num_vars = 0;
     pt_num_xvars = 0;
     pt_argmap = 0;
@@ -150,6 +151,7 @@ IFparseTree::IFparseTree(sCKT *ct, const char *xa)
     pt_pn_size = 0;
 
     pt_error = false;
+    pt_notape = false;
     pt_macro = false;
 }
 
@@ -162,6 +164,7 @@ IFparseTree::~IFparseTree()
     delete [] pt_xalias;
     delete [] pt_vars;
     delete [] pt_derivs;
+    delete pt_tape;
     while (pt_pn_blocks) {
         pn_block *px = pt_pn_blocks;
         pt_pn_blocks = pt_pn_blocks->next;
@@ -377,8 +380,44 @@ namespace {
 // a comma, result will contain the 2 values, and *docomma will be
 // incremented twice.  Otherwise, this is a syntax error.
 //
+// When simulating, the tree and derivatives are compiled into a tape
+// on first use, which is evaluated instead of the trees unless the
+// noexprtape option is set.  If the tape evaluation fails or raises
+// a floating-point exception, the trees are evaluated, which
+// provides the error messages.
+//
 int
 IFparseTree::eval(double *result, double *vals, double *dvs, int *docomma)
+{
+    if (pt_tree && !pt_notape && pt_ckt && pt_ckt->CKTcurTask &&
+            !pt_ckt->CKTcurTask->TSKnoExprTape &&
+            !(docomma && pt_tree->p_type == PT_COMMA)) {
+        if (dvs && !pt_derivs)
+            differentiate();
+        if (!pt_tape ||
+                (dvs && pt_num_vars > 0 && !pt_tape->has_derivs())) {
+            delete pt_tape;
+            pt_tape = PTtape::compile(pt_tree, dvs ? pt_derivs : 0,
+                dvs ? pt_num_vars : 0);
+            if (!pt_tape)
+                pt_notape = true;
+        }
+        if (pt_tape) {
+            check_fpe(true);
+            if (pt_tape->eval(result, dvs, vals) == OK &&
+                    check_fpe(false) == OK)
+                return (OK);
+        }
+    }
+    return (evalTree(result, vals, dvs, docomma));
+}
+
+
+// Evaluate by traversing the parse trees.
+//
+int
+IFparseTree::evalTree(double *result, double *vals, double *dvs,
+    int *docomma)
 {
     Errs()->init_error();
     if (!pt_tree)
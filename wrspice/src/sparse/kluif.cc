@@ -44,10 +44,15 @@
 #include "spglobal.h"
 #include "miscutil/lstring.h"
 #include <math.h>
+#include <stdint.h>
+#include <pthread.h>
 #ifdef WIN32
 #include <windows.h>
+#include <process.h>
+#include <io.h>
 #else
 #include <dlfcn.h>
+#include <unistd.h>
 #endif
 
 //
@@ -263,6 +268,360 @@ KLUif::find_klu()
 // End of KLUif functions.
 
 
+//
+// Cache for symbolic analysis results.  The symbolic analysis
+// (ordering) depends only on the matrix sparsity pattern, so it can be
+// shared between matrices with the same pattern.  This is the case
+// when the same circuit is run repeatedly, as in Monte Carlo and loop
+// analysis, and for the per-thread circuit copies used in multi-
+// threaded analysis.  The klu_symbolic is read-only in KLU after
+// creation, so may be used concurrently.
+//
+// If the environment variable XT_KLU_SYMCACHE is set to a directory
+// path, analysis results are also saved there, and will be used by
+// subsequent WRspice processes simulating the same circuit topology.
+//
+
+// Maximum number of unreferenced cached entries retained.
+#define KLU_SYMCACHE_MAX 16
+
+// On-disk file magic number, change if format changes.
+#define KLU_SYMCACHE_MAGIC 0x4b4c5331
+
+namespace {
+    struct sKLUsymEnt
+    {
+        sKLUsymEnt(klu_symbolic *s, int n, const int *ap, const int *ai,
+                int ord, unsigned int h, bool d)
+            {
+                next = 0;
+                symbolic = s;
+                size = n;
+                nz = ap[n];
+                Ap = new int[n+1];
+                memcpy(Ap, ap, (n+1)*sizeof(int));
+                Ai = new int[nz];
+                memcpy(Ai, ai, nz*sizeof(int));
+                ordering = ord;
+                hash = h;
+                refcnt = 0;
+                fromdisk = d;
+            }
+
+        ~sKLUsymEnt();
+
+        bool match(int n, const int *ap, const int *ai, int ord,
+            unsigned int h) const
+            {
+                return (h == hash && n == size && ord == ordering &&
+                    ap[n] == nz &&
+                    !memcmp(ap, Ap, (n+1)*sizeof(int)) &&
+                    !memcmp(ai, Ai, nz*sizeof(int)));
+            }
+
+        sKLUsymEnt *next;
+        klu_symbolic *symbolic;
+        int *Ap;
+        int *Ai;
+        int size;
+        int nz;
+        int ordering;
+        unsigned int hash;
+        int refcnt;
+        bool fromdisk;      // Allocated here, not by KLU.
+    };
+
+
+    struct sKLUsymCache
+    {
+        sKLUsymCache()
+            {
+                sc_list = 0;
+                pthread_mutex_init(&sc_lock, 0);
+            }
+
+        klu_symbolic *get(int, int*, int*, klu_common*);
+        void release(klu_symbolic*);
+
+    private:
+        void trim();
+        klu_symbolic *read_file(int, const int*, const int*, int,
+            unsigned int);
+        void write_file(const sKLUsymEnt*);
+        char *file_name(int, int, unsigned int);
+
+        static unsigned int hash(int n, const int *ap, const int *ai)
+            {
+                // FNV-1a
+                unsigned int h = 2166136261u;
+                for (int i = 0; i <= n; i++)
+                    h = (h ^ (unsigned int)ap[i]) * 16777619u;
+                int nz = ap[n];
+                for (int i = 0; i < nz; i++)
+                    h = (h ^ (unsigned int)ai[i]) * 16777619u;
+                return (h);
+            }
+
+        sKLUsymEnt *sc_list;        // Most-recently used first.
+        pthread_mutex_t sc_lock;
+    };
+
+    sKLUsymCache sym_cache;
+
+
+    sKLUsymEnt::~sKLUsymEnt()
+    {
+        if (fromdisk) {
+            delete [] symbolic->Lnz;
+            delete [] symbolic->P;
+            delete [] symbolic->Q;
+            delete [] symbolic->R;
+            delete symbolic;
+        }
+        else {
+            klu_common common;
+            klu_if.klu_defaults(&common);
+            klu_if.klu_free_symbolic(&symbolic, &common);
+        }
+        delete [] Ap;
+        delete [] Ai;
+    }
+
+
+    // Return a symbolic analysis for the matrix, from the cache if
+    // possible.  The return must be passed to release when no longer
+    // needed.
+    //
+    klu_symbolic *
+    sKLUsymCache::get(int n, int *ap, int *ai, klu_common *common)
+    {
+        unsigned int h = hash(n, ap, ai);
+        pthread_mutex_lock(&sc_lock);
+        sKLUsymEnt *ep = 0;
+        for (sKLUsymEnt *e = sc_list; e; ep = e, e = e->next) {
+            if (e->match(n, ap, ai, common->ordering, h)) {
+                if (ep) {
+                    ep->next = e->next;
+                    e->next = sc_list;
+                    sc_list = e;
+                }
+                e->refcnt++;
+                pthread_mutex_unlock(&sc_lock);
+                return (e->symbolic);
+            }
+        }
+
+        // Not found, the analysis is done while locked, other
+        // threads are likely waiting for the same result.
+        bool fromdisk = true;
+        klu_symbolic *sym = read_file(n, ap, ai, common->ordering, h);
+        if (!sym) {
+            fromdisk = false;
+            sym = klu_if.klu_analyze(n, ap, ai, common);
+            if (!sym) {
+                pthread_mutex_unlock(&sc_lock);
+                return (0);
+            }
+        }
+        sKLUsymEnt *e = new sKLUsymEnt(sym, n, ap, ai, common->ordering, h,
+            fromdisk);
+        e->refcnt++;
+        e->next = sc_list;
+        sc_list = e;
+        if (!fromdisk)
+            write_file(e);
+        trim();
+        pthread_mutex_unlock(&sc_lock);
+        return (sym);
+    }
+
+
+    // Decrement the reference count of a symbolic analysis obtained
+    // from get.
+    //
+    void
+    sKLUsymCache::release(klu_symbolic *sym)
+    {
+        if (!sym)
+            return;
+        pthread_mutex_lock(&sc_lock);
+        for (sKLUsymEnt *e = sc_list; e; e = e->next) {
+            if (e->symbolic == sym) {
+                e->refcnt--;
+                break;
+            }
+        }
+        trim();
+        pthread_mutex_unlock(&sc_lock);
+    }
+
+
+    // Free the least-recently used unreferenced entries in excess of
+    // KLU_SYMCACHE_MAX.  Call with the lock held.
+    //
+    void
+    sKLUsymCache::trim()
+    {
+        int cnt = 0;
+        sKLUsymEnt *ep = 0, *en;
+        for (sKLUsymEnt *e = sc_list; e; e = en) {
+            en = e->next;
+            if (e->refcnt <= 0 && ++cnt > KLU_SYMCACHE_MAX) {
+                if (ep)
+                    ep->next = en;
+                else
+                    sc_list = en;
+                delete e;
+                continue;
+            }
+            ep = e;
+        }
+    }
+
+
+    // Return the on-disk cache file name, or null if not enabled.
+    //
+    char *
+    sKLUsymCache::file_name(int n, int nz, unsigned int h)
+    {
+        const char *dir = getenv("XT_KLU_SYMCACHE");
+        if (!dir || !*dir)
+            return (0);
+        char buf[64];
+        snprintf(buf, sizeof(buf), "/klusym_%08x_%d_%d", h, n, nz);
+        char *fn = new char[strlen(dir) + strlen(buf) + 1];
+        strcpy(fn, dir);
+        strcat(fn, buf);
+        return (fn);
+    }
+
+
+    // Read a symbolic analysis from the on-disk cache, if enabled.
+    // The file contains the sparsity pattern, which must match.
+    //
+    klu_symbolic *
+    sKLUsymCache::read_file(int n, const int *ap, const int *ai, int ord,
+        unsigned int h)
+    {
+        int nz = ap[n];
+        char *fn = file_name(n, nz, h);
+        if (!fn)
+            return (0);
+        FILE *fp = fopen(fn, "rb");
+        delete [] fn;
+        if (!fp)
+            return (0);
+
+        bool ok = false;
+        int hdr[4];
+        int *tap = 0, *tai = 0;
+        klu_symbolic *sym = 0;
+        if (fread(hdr, sizeof(int), 4, fp) != 4 ||
+                hdr[0] != KLU_SYMCACHE_MAGIC || hdr[1] != n ||
+                hdr[2] != nz || hdr[3] != ord)
+            goto done;
+        tap = new int[n+1];
+        tai = new int[nz];
+        if (fread(tap, sizeof(int), n+1, fp) != (size_t)(n+1) ||
+                fread(tai, sizeof(int), nz, fp) != (size_t)nz)
+            goto done;
+        if (memcmp(tap, ap, (n+1)*sizeof(int)) ||
+                memcmp(tai, ai, nz*sizeof(int)))
+            goto done;
+
+        sym = new klu_symbolic;
+        memset(sym, 0, sizeof(klu_symbolic));
+        sym->Lnz = new double[n];
+        sym->P = new int[n];
+        sym->Q = new int[n];
+        sym->R = new int[n+1];
+        if (fread(&sym->symmetry, sizeof(double), 1, fp) != 1 ||
+                fread(&sym->est_flops, sizeof(double), 1, fp) != 1 ||
+                fread(&sym->lnz, sizeof(double), 1, fp) != 1 ||
+                fread(&sym->unz, sizeof(double), 1, fp) != 1 ||
+                fread(&sym->nzoff, sizeof(int), 1, fp) != 1 ||
+                fread(&sym->nblocks, sizeof(int), 1, fp) != 1 ||
+                fread(&sym->maxblock, sizeof(int), 1, fp) != 1 ||
+                fread(&sym->do_btf, sizeof(int), 1, fp) != 1 ||
+                fread(&sym->structural_rank, sizeof(int), 1, fp) != 1 ||
+                fread(sym->Lnz, sizeof(double), n, fp) != (size_t)n ||
+                fread(sym->P, sizeof(int), n, fp) != (size_t)n ||
+                fread(sym->Q, sizeof(int), n, fp) != (size_t)n ||
+                fread(sym->R, sizeof(int), n+1, fp) != (size_t)(n+1))
+            goto done;
+        sym->n = n;
+        sym->nz = nz;
+        sym->ordering = ord;
+        ok = true;
+    done:
+        fclose(fp);
+        delete [] tap;
+        delete [] tai;
+        if (!ok && sym) {
+            delete [] sym->Lnz;
+            delete [] sym->P;
+            delete [] sym->Q;
+            delete [] sym->R;
+            delete sym;
+            sym = 0;
+        }
+        return (sym);
+    }
+
+
+    // Save a symbolic analysis to the on-disk cache, if enabled.  The
+    // file is written under a temporary name and renamed, so that
+    // concurrent processes never see a partial file.
+    //
+    void
+    sKLUsymCache::write_file(const sKLUsymEnt *e)
+    {
+        char *fn = file_name(e->size, e->nz, e->hash);
+        if (!fn)
+            return;
+        char *tfn = new char[strlen(fn) + 16];
+        sprintf(tfn, "%s.%d", fn, (int)getpid());
+        FILE *fp = fopen(tfn, "wb");
+        if (!fp) {
+            delete [] tfn;
+            delete [] fn;
+            return;
+        }
+        const klu_symbolic *sym = e->symbolic;
+        int n = e->size;
+        int hdr[4];
+        hdr[0] = KLU_SYMCACHE_MAGIC;
+        hdr[1] = n;
+        hdr[2] = e->nz;
+        hdr[3] = e->ordering;
+        bool ok =
+            fwrite(hdr, sizeof(int), 4, fp) == 4 &&
+            fwrite(e->Ap, sizeof(int), n+1, fp) == (size_t)(n+1) &&
+            fwrite(e->Ai, sizeof(int), e->nz, fp) == (size_t)e->nz &&
+            fwrite(&sym->symmetry, sizeof(double), 1, fp) == 1 &&
+            fwrite(&sym->est_flops, sizeof(double), 1, fp) == 1 &&
+            fwrite(&sym->lnz, sizeof(double), 1, fp) == 1 &&
+            fwrite(&sym->unz, sizeof(double), 1, fp) == 1 &&
+            fwrite(&sym->nzoff, sizeof(int), 1, fp) == 1 &&
+            fwrite(&sym->nblocks, sizeof(int), 1, fp) == 1 &&
+            fwrite(&sym->maxblock, sizeof(int), 1, fp) == 1 &&
+            fwrite(&sym->do_btf, sizeof(int), 1, fp) == 1 &&
+            fwrite(&sym->structural_rank, sizeof(int), 1, fp) == 1 &&
+            fwrite(sym->Lnz, sizeof(double), n, fp) == (size_t)n &&
+            fwrite(sym->P, sizeof(int), n, fp) == (size_t)n &&
+            fwrite(sym->Q, sizeof(int), n, fp) == (size_t)n &&
+            fwrite(sym->R, sizeof(int), n+1, fp) == (size_t)(n+1);
+        if (fclose(fp) != 0)
+            ok = false;
+        if (!ok || rename(tfn, fn) != 0)
+            unlink(tfn);
+        delete [] tfn;
+        delete [] fn;
+    }
+}
+// End of symbolic cache functions.
+
+
 KLUmatrix::KLUmatrix(int size, int nelts, bool cplx, bool ldbl) :
     spMatlabMatrix(size, nelts, cplx, ldbl)
 {
@@ -282,7 +641,7 @@ KLUmatrix::~KLUmatrix()
     delete [] Ainit;
     delete [] RhsTmp;
     if (klu_if.is_ok()) {
-        klu_if.klu_free_symbolic(&Symbolic, &Common);
+        sym_cache.release(Symbolic);
         if (Complex)
             klu_if.klu_z_free_numeric(&Numeric, &Common);
         else if (LongDoubles)
@@ -570,8 +929,8 @@ KLUmatrix::factor()
     if (!klu_if.is_ok())
         return (spPANIC);
     Common.status = KLU_OK;
-    klu_if.klu_free_symbolic(&Symbolic, &Common);
-    Symbolic = klu_if.klu_analyze(Size, Ap, Ai, &Common);
+    sym_cache.release(Symbolic);
+    Symbolic = sym_cache.get(Size, Ap, Ai, &Common);
     if (Complex) {
         klu_if.klu_z_free_numeric(&Numeric, &Common);
         Numeric = klu_if.klu_z_factor(Ap, Ai, Ax, Symbolic, &Common);
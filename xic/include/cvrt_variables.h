@@ -63,6 +63,9 @@
 // Convert Menu - Input and ASCII Output
 #define VA_ChdLoadTopOnly           "ChdLoadTopOnly"
 #define VA_ChdRandomGzip            "ChdRandomGzip"
+#define VA_ChdGzipThreads           "ChdGzipThreads"
+#define VA_ChdFlatJobs              "ChdFlatJobs"
+#define VA_NoInputMmap              "NoInputMmap"
 #define VA_AutoRename               "AutoRename"
 #define VA_NoCreateLayer            "NoCreateLayer"
 #define VA_NoAskOverwrite           "NoAskOverwrite"
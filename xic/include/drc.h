@@ -58,6 +58,7 @@ struct SIlexprCx;
 struct siVariable;
 struct Zlist;
 struct Zgroup;
+struct DRCgrid;
 namespace drc_user { struct TestState; }
 namespace drc_results { struct DRCresultParser; }
 
@@ -77,6 +78,7 @@ namespace drc_results { struct DRCresultParser; }
 #define VA_DrcChdName           "DrcChdName"
 #define VA_DrcChdCell           "DrcChdCell"
 #define VA_DrcPartitionSize     "DrcPartitionSize"
+#define VA_DrcPartitionJobs     "DrcPartitionJobs"
 
 // Log file prefix
 #define DRC_EFILE_PREFIX "drcerror.log"
@@ -95,6 +97,10 @@ namespace drc_results { struct DRCresultParser; }
 #define DRC_PART_MAX 10000.0
 #define DRC_PART_DEF 200.0
 
+// Number of processes used to check partition grid regions.
+#define DRC_PART_JOBS_MIN 1
+#define DRC_PART_JOBS_MAX 64
+
 // Other parameter defaults and limits.
 #define DRC_MAX_ERRS_MIN        0
 #define DRC_MAX_ERRS_MAX        100000
@@ -1275,6 +1281,8 @@ public:
 
     int gridSize()            const { return (drc_grid_size); }
     void setGridSize(int g)         { drc_grid_size = g; }
+    int gridJobs()            const { return (drc_grid_jobs); }
+    void setGridJobs(int j)         { drc_grid_jobs = j; }
 
     int getObjCount()         const { return (drc_obj_count); }
     int getErrCount()         const { return (drc_err_count); }
@@ -1323,6 +1331,12 @@ private:
     void close_drc(Blist*);
     bool skip_layer(const CDl*);
     bool update_rule_disable();
+    XIrt grid_region(const DRCgrid*, int, FILE*);
+    XIrt grid_regions(const DRCgrid*, FILE*, unsigned int*, unsigned int*);
+#ifndef WIN32
+    bool grid_fork_regions(const DRCgrid*, FILE*, unsigned int*,
+        unsigned int*, XIrt*);
+#endif
 
     // drc_results.cc
     bool altShowError(WindowDesc*, bool);
@@ -1363,6 +1377,7 @@ private:
     bool drc_abort;                 // Stop run now.
 
     unsigned int drc_grid_size;     // Area partitioning size.
+    unsigned int drc_grid_jobs;     // Processes used for partitions.
 
     // These are set by the evaluation functions.
     unsigned int drc_obj_count;     // Number of objects to test.
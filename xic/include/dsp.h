@@ -233,6 +233,7 @@ public:
     // dsp_image.cc
     GRimage *CreateImage(cCHD*, const char*, BBox*, unsigned int,
         unsigned int, int = -1);
+    void ClearImageCaches();
 
     // dsp_label.cc
     int DefaultLabelSize(const char*, DisplayMode, int*, int*);
@@ -438,6 +439,11 @@ public:
     bool SlowMode()                         { return (d_slow_mode); }
     void SetSlowMode(bool b)                { d_slow_mode = b; }
 
+    // Database change count, the saved window images are keyed by
+    // this.
+    unsigned int DbGeneration()             { return (d_db_generation); }
+    void DbChanged()                        { d_db_generation++; }
+
     bool DoingHcopy()                       { return (d_doing_hcopy); }
     void SetDoingHcopy(bool b)              { d_doing_hcopy = b; }
     bool NoPixmapStore()                    { return (d_no_pixmap_store); }
@@ -516,6 +522,7 @@ private:
     int d_phys_prop_size;       // Size of text used for physical properties.
     int d_term_text_size;       // Size of text used for terminals.
     int d_term_mark_size;       // Size of mark used for terminals.
+    unsigned int d_db_generation;   // Database change count.
 
     double d_phys_char_width;   // Default size of char cell for labels,
     double d_phys_char_height;  // in microns.
@@ -304,6 +304,45 @@ enum DirectionType
     DirSouthWest
 };
 
+// Save this many rendered full-window images per window.
+#define DSP_IMGCACHE_SIZE 4
+
+// A rendered full-window local image, and the view state it was
+// rendered in.  These are kept by the window so that returning to a
+// view (zoom back, pan back, view history) can reuse the image
+// rather than traverse the database again.  This reuses exact views
+// only, it is not a tile cache, a new view is always rendered in
+// full.
+//
+struct wImgElt
+{
+    wImgElt(const unsigned int*, unsigned int, unsigned int, wImgElt*);
+    ~wImgElt() { delete [] data; }
+
+    static void destroy(wImgElt *e)
+        {
+            while (e) {
+                wImgElt *ex = e;
+                e = e->next;
+                delete ex;
+            }
+        }
+
+    BBox BB;                    // window area
+    double ratio;               // viewport width / window width
+    CDcellName topname;         // top cell name
+    CDcellName curname;         // current cell name
+    unsigned int *data;         // image pixels
+    wImgElt *next;
+    unsigned int width;         // image width
+    unsigned int height;        // image height
+    unsigned int displflag;     // cell expansion flag
+    int explev;                 // expansion level
+    int numgeom;                // object count when rendered
+    unsigned int dbgen;         // database generation when rendered
+    DisplayMode mode;           // Physical or Electrical
+};
+
 #define DSP_CACHE_SIZE 500
 
 // Cache objects for accelerated rendering.
@@ -490,6 +529,7 @@ struct WindowDesc
     // dsp_image.cc
     GRimage *CreateImage(const BBox*, int* = 0);
     GRimage *CreateChdImage(cCHD*, const char*, const BBox*, int);
+    void ClearImageCache();
 
     // dsp_label.cc
     void ShowLabel(const Label*);
@@ -697,6 +737,10 @@ private:
     bool show_boundaries(symref_t*, bnd_draw_t*, int);
     int redisplay_cddb_zimg(const BBox*);
     int redisplay_cddb_zimg_rc(CDs*, int, w_rdl_state*, bool);
+    GRimage *find_cached_image(int*);
+    void save_cached_image(const GRimage*, int);
+    void check_image_cache(const BBox*);
+    void invalidate_image_cache(const BBox*);
 
     // dsp_label.cc
     void show_label(const void*, int, int, int, int, int, bool,
@@ -747,6 +791,7 @@ private:
     char *w_dbcellname;         // cellname for database display
 
     RGBzimg *w_rgbimg;          // local image
+    wImgElt *w_imgcache;        // saved full-window images, MRU first
 
     DisplayMode w_mode;         // Physical or Electrical
     unsigned int w_displflag;   // cell expansion flag
@@ -762,6 +807,7 @@ private:
     bool w_using_pixmap;        // using backing store
     bool w_using_image;         // using in-core image
     bool w_old_image;           // using old image composition logic
+    bool w_view_change;         // view changed, not yet redisplayed
 
     w_win_str w_win;            // window view alternate mode store
     unsigned long w_windowid;   // window identifier
@@ -52,6 +52,7 @@
 #define VA_NoMergePolys         "NoMergePolys"
 // #define VA_AskSaveNative        "AskSaveNative"
 // #define VA_NoFixRot45           "NoFixRot45"
+#define VA_SweepBooleans        "SweepBooleans"
 
 // Side Menu Commands (see sced.h)
 #define VA_MasterMenuLength     "MasterMenuLength"
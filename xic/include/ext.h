@@ -74,6 +74,7 @@
 #define VA_RLSolverTryTile      "RLSolverTryTile"
 #define VA_RLSolverGridPoints   "RLSolverGridPoints"
 #define VA_RLSolverMaxPoints    "RLSolverMaxPoints"
+#define VA_RLSolverIterative    "RLSolverIterative"
 #define VA_SubcPermutationFix   "SubcPermutationFix"
 #define VA_VerbosePromptline    "VerbosePromptline"
 #define VA_ViaCheckBtwnSubs     "ViaCheckBtwnSubs"
@@ -661,6 +662,8 @@ public:
 private:
     // ext_group.cc
     XIrt group_rec(CDs*, int, SymTab*);
+    XIrt group_mt(CDs*, int, SymTab*);
+    void group_done(CDs*, XIrt);
 
     // ext_nets.cc
     void reset_all_terms(CDs*);
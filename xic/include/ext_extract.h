@@ -2041,6 +2041,8 @@ public:
 
     // ext_group.cc
     XIrt setup_groups();
+    bool setup_excludes();
+    XIrt finish_groups();
     void clear_groups(bool = false);
     CDo *intersect_phony(BBox*);
     void dump(FILE*);
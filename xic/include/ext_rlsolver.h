@@ -117,6 +117,51 @@ struct RLcontact
 // Initialization state
 enum RLstate { RLuninit, RLresist, RLinduct };
 
+// Conductance list for the iterative solver.  These are the grid
+// elements, node 0 is ground.  With ground and the other fixed nodes
+// removed, the system is symmetric positive definite and is solved
+// by conjugate gradients with diagonal preconditioning.
+//
+struct RLgrid
+{
+    RLgrid()
+        {
+            g_n1 = 0;
+            g_n2 = 0;
+            g_val = 0;
+            g_inv = 0;
+            g_num = 0;
+            g_alloc = 0;
+            g_size = 0;
+            g_iters = 0;
+        }
+
+    ~RLgrid()
+        {
+            delete [] g_n1;
+            delete [] g_n2;
+            delete [] g_val;
+            delete [] g_inv;
+        }
+
+    int size()                  { return (g_size); }
+    int iterations()            { return (g_iters); }
+
+    void add(int, int, double);
+    void mult(const double*, double*, int);
+    bool pcg(double*, const double*, int, const bool*);
+
+private:
+    int *g_n1;                  // first node of element
+    int *g_n2;                  // second node of element
+    double *g_val;              // element conductance
+    double *g_inv;              // inverse diagonal, preconditioner
+    int g_num;                  // number of elements
+    int g_alloc;                // allocated size of element arrays
+    int g_size;                 // largest node number
+    int g_iters;                // iterations used in last pcg call
+};
+
 // Struct to support per-square extraction (resistance and inductance).
 //
 struct RLsolver
@@ -124,6 +169,7 @@ struct RLsolver
     RLsolver()
         {
             rl_matrix = 0;
+            rl_grid = 0;
             rl_zlist = 0;
             rl_h_edges = 0;
             rl_v_edges = 0;
@@ -208,9 +254,11 @@ private:
     int find_tile();
     void set_delta();
     void add_element(int, int, double = 1.0);
+    bool solve_multi_iter(int, int*, float**);
     double l_per_sq(int);
 
     spMatrixFrame *rl_matrix;   // the matrix
+    RLgrid *rl_grid;            // the elements, when iterative
     Zlist *rl_zlist;            // body area
     RLedge *rl_h_edges;         // horizontal edges
     RLedge *rl_v_edges;         // vertical edges
@@ -231,6 +279,7 @@ public:
     static int rl_maxgrid;      // maximum number of grid cells, used
                                 // when tiling
     static bool rl_try_tile;    // attempt to tile
+    static bool rl_iterative;   // use iterative solver
 };
 
 
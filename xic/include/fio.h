@@ -712,6 +712,15 @@ public:
     unsigned int ChdRandomGzip()        { return (fioChdRandomGzip); }
     void SetChdRandomGzip(unsigned int n) { fioChdRandomGzip = n; }
 
+    unsigned int ChdGzipThreads()       { return (fioChdGzipThreads); }
+    void SetChdGzipThreads(unsigned int n) { fioChdGzipThreads = n; }
+
+    unsigned int ChdFlatJobs()          { return (fioChdFlatJobs); }
+    void SetChdFlatJobs(unsigned int n) { fioChdFlatJobs = n; }
+
+    bool IsNoInputMmap()                { return (fioNoInputMmap); }
+    void SetNoInputMmap(bool b)         { fioNoInputMmap = b; }
+
     bool IsAutoRename()                 { return (fioAutoRename); }
     void SetAutoRename(bool b)          { fioAutoRename = b; }
 
@@ -880,6 +889,10 @@ public:
                                           fioOasWriteCompressed); }
     void SetOasWriteCompressed(OAScompType t) { fioOasWriteCompressed = t; }
 
+    // This tracks the Threads variable.
+    unsigned int NumThreads()           { return (fioNumThreads); }
+    void SetNumThreads(unsigned int n)  { fioNumThreads = n; }
+
     bool IsOasWriteNameTab()            { return (fioOasWriteNameTab); }
     void SetOasWriteNameTab(bool b)     { fioOasWriteNameTab = b; }
 
@@ -1066,6 +1079,18 @@ private:
         // when accessing with CHD.  The value is the number of Mb per
         // access point.
 
+    unsigned char fioChdGzipThreads;
+        // If greater than one, gzipped files with a random access
+        // map are inflated by this many threads.
+
+    unsigned char fioChdFlatJobs;
+        // If greater than one, the CHD flat reads into special
+        // databases are split over this many worker processes.
+
+    bool fioNoInputMmap;
+        // Read uncompressed input files with stdio rather than
+        // through a memory map.
+
     bool fioAutoRename;
         // Turn on automatic cell renaming when reading input and cell
         // names clash.
@@ -1218,6 +1243,11 @@ private:
     unsigned char fioOasWriteCompressed;
         // Use CBLOCKs in OASIS output.
 
+    unsigned char fioNumThreads;
+        // Number of helper threads, from the Threads variable.  If
+        // nonzero, cell CBLOCKs in OASIS output are compressed in
+        // parallel.
+
     bool fioOasWriteNameTab;
         // Use strict-mode string tables in OASIS output.
 
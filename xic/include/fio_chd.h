@@ -53,6 +53,7 @@ struct sChdPrp;
 struct Sdiff;
 struct zio_stream;
 struct zio_index;
+struct zio_index_bg;
 
 // Argument to cCHD::writeFlatRegions.
 //
@@ -187,7 +188,7 @@ public:
         unsigned int, int, unsigned int, bool, bool);
 
     // fio_zio.cc
-    bool registerRandomMap();
+    bool registerRandomMap(zio_index_bg* = 0);
     bool unregisterRandomMap();
     static zio_index *getRandomMap(unsigned int);
 
@@ -246,6 +247,13 @@ private:
     bool setBoundaries_rcprv(symref_t*, unsigned int);
     bool instanceBoundaries_rc(symref_t*, fio_chd::ib_t*, unsigned int = 0);
 
+    // fio_chd_flat.cc
+    OItype readFlat_bk(const char*, const FIOcvtPrms*, cv_backend*);
+#ifndef WIN32
+    bool readFlat_fork(const char*, const FIOcvtPrms*, cv_backend*,
+        unsigned int, OItype*);
+#endif
+
     // fio_chd_split.cc
     OItype write_multi_hier(symref_t*, const FIOcvtPrms*, const Blist*,
         unsigned int, int);
@@ -76,6 +76,10 @@ struct cv_chd_iter
             ci_symref2 = 0;
             ci_db1 = 0;
             ci_db2 = 0;
+            ci_cname1 = 0;
+            ci_cname2 = 0;
+            ci_nxc = 0;
+            ci_nyc = 0;
 
             ci_coarse_grid = cgm*fg;
             ci_fine_grid = fg;
@@ -91,13 +95,22 @@ struct cv_chd_iter
 protected:
     virtual XIrt iterFunc(const BBox*) = 0;
 
+    XIrt setup2(cCHD*, const char*, cCHD*, const char*, const BBox*);
+    XIrt region2(int);
+    void region_bb(int, BBox*);
+    int num_regions()               const { return (ci_nxc*ci_nyc); }
+
     cCHD *ci_chd1;
     cCHD *ci_chd2;
     symref_t *ci_symref1;
     symref_t *ci_symref2;
     cSDB *ci_db1;
     cSDB *ci_db2;
+    const char *ci_cname1;
+    const char *ci_cname2;
     BBox ci_aoiBB;
+    int ci_nxc;
+    int ci_nyc;
     int ci_coarse_grid;
     int ci_fine_grid;
     int ci_bloat_val;
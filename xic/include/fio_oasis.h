@@ -931,6 +931,7 @@ private:
 class cCGD;
 struct cgd_layer_mux;
 struct oas_cache;
+struct oas_zqueue;
 
 // Class for generating OASIS output
 //
@@ -996,6 +997,7 @@ private:
 
     bool begin_compression(const char*);
     bool end_compression();
+    bool flush_zqueue();
 
     bool setup_properties(CDp*);
     void set_layer_dt(int, int, int* = 0, int* = 0);
@@ -1036,6 +1038,7 @@ private:
     oas_modal   *out_modal;                 // modal variables
     zio_stream  *out_zfile;                 // zlib file pointer
     oas_cache   *out_cache;                 // repetition cache
+    oas_zqueue  *out_zqueue;                // threaded CBLOCK compression
     unsigned char *out_compr_buf;           // buffer for compression
     const char  *out_rep_args;              // repetition cache args
     int         out_undef_count;            // unmapped layer indices
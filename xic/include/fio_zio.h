@@ -44,6 +44,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <pthread.h>
 #include <zlib.h>
 
 
@@ -58,6 +59,7 @@
 #define Z_WINSIZE   32768U
 
 struct zio_index;
+struct zio_ahead;
 struct sFilePtr;
 
 // Low-level zlib interface
@@ -107,6 +109,10 @@ struct zio_stream
 
 private:
     int seek_to(int64_t, zio_index*);
+    bool new_ahead();
+    bool use_ahead();
+    int ahead_fill();
+    bool ahead_seek(int64_t, zio_index*);
     int read_core(void*, unsigned int);
     int flush(int);
     int get_byte();
@@ -117,6 +123,7 @@ private:
     z_stream        z_strm;
     FILE            *z_fp;          // .gz file
     sFilePtr        *z_zfp;         // input stream
+    zio_ahead       *z_ahead;       // parallel inflate, random map reads
     Byte            *z_inbuf;       // input buffer
     Byte            *z_outbuf;      // output buffer
     char            *z_ptr;         // output buffer pointer for reading
@@ -212,7 +219,19 @@ struct zio_index
             return &zi_list[mid];
         }
 
-    int build_index(FILE*, unsigned int);
+    // Access point list index of p, and the reverse.
+    int point_num(const point_t *p) { return (p - zi_list); }
+
+    point_t *point(int i)
+        {
+            return (i >= 0 && i < zi_have ? zi_list + i : 0);
+        }
+
+    int num_points()        { return (zi_have); }
+
+    int build_index(FILE*, unsigned int, const volatile bool* = 0);
+    static int inflate_span(int, const point_t*, unsigned char**,
+        unsigned int*, uint64_t, unsigned char* = 0);
     bool to_file(const char*);
     bool from_file(const char*);
 
@@ -233,8 +252,70 @@ private:
 };
 
 
-// "FILE" pointer: use stdio for uncompressed files, zio_stream for
-// compressed files.
+// Build a zio_index for a gzipped file in a separate thread, so that
+// the inflation pass overlaps other work on the file, such as the
+// CHD creation pass.
+//
+struct zio_index_bg
+{
+    zio_index_bg(const char*);
+    ~zio_index_bg();
+
+    zio_index *finish();
+
+    // Ask the thread to quit early, the index is discarded.
+    void cancel()           { bg_cancel = true; }
+
+private:
+    static void *bg_proc(void*);
+
+    char *bg_fname;         // file to index
+    zio_index *bg_index;    // the index, or null on error
+    pthread_t bg_thread;
+    unsigned int bg_span;   // uncompressed bytes between access points
+    bool bg_running;        // thread not yet joined
+    volatile bool bg_cancel; // polled by the thread
+};
+
+
+// Read-only memory map of an uncompressed input file.  Maps are
+// reference counted and shared, all readers open on the same file
+// use the same map.
+//
+struct zio_mmap
+{
+    static zio_mmap *open_map(FILE*);
+    static void close_map(zio_mmap*);
+
+    const unsigned char *base()     const { return (zm_base); }
+    int64_t size()                  const { return (zm_size); }
+
+private:
+    zio_mmap()
+        {
+            zm_base = 0;
+            zm_size = 0;
+            zm_dev = 0;
+            zm_ino = 0;
+            zm_mtime = 0;
+            zm_refcnt = 0;
+            zm_next = 0;
+        }
+
+    const unsigned char *zm_base;   // mapped file data
+    int64_t zm_size;                // file size
+    dev_t zm_dev;                   // file identification
+    ino_t zm_ino;
+    time_t zm_mtime;
+    int zm_refcnt;                  // number of users
+    zio_mmap *zm_next;
+
+    static zio_mmap *zm_list;       // list of active maps
+};
+
+
+// "FILE" pointer: use stdio or a memory map for uncompressed files,
+// zio_stream for compressed files.
 //
 struct sFilePtr
 {
@@ -242,14 +323,30 @@ struct sFilePtr
         {
             file = f;
             fp = p;
+            map = 0;
+            map_pos = 0;
             keep_fp = false;
+            map_eof = false;
         }
 
     sFilePtr(zio_stream *f, FILE *p, bool k)
         {
             file = f;
             fp = p;
+            map = 0;
+            map_pos = 0;
             keep_fp = k;
+            map_eof = false;
+        }
+
+    sFilePtr(zio_mmap *m)
+        {
+            file = 0;
+            fp = 0;
+            map = m;
+            map_pos = 0;
+            keep_fp = false;
+            map_eof = false;
         }
 
     ~sFilePtr()
@@ -264,6 +361,8 @@ struct sFilePtr
                 else
                     fclose(fp);
             }
+            if (map)
+                zio_mmap::close_map(map);
         }
 
     static sFilePtr *newFilePtr(const char*, const char*);
@@ -281,13 +380,17 @@ struct sFilePtr
     inline char *z_gets(char*, int);
     inline unsigned int z_crc();
     inline void z_set_crc(unsigned int);
+    inline const unsigned char *z_mapped(size_t);
 
     int z_seek(int64_t, int);
     int64_t z_tell();
 
     zio_stream *file;
     FILE *fp;
+    zio_mmap *map;
+    int64_t map_pos;
     bool keep_fp;
+    bool map_eof;
 };
 typedef sFilePtr* FilePtr;
 
@@ -297,6 +400,8 @@ sFilePtr::z_puts(const char *s)
 {
     if (file)
         return (file->zio_write(s, strlen(s)));
+    else if (map)
+        return (EOF);
     else if (fp) {
         int r = fputs(s, fp);
 #ifndef WIN32
@@ -317,6 +422,8 @@ sFilePtr::z_putc(int c)
 {
     if (file)
         return (file->zio_putc(c));
+    else if (map)
+        return (EOF);
     else if (fp) {
         int r = putc(c, fp);
 #ifndef WIN32
@@ -339,6 +446,12 @@ sFilePtr::z_getc()
 {
     if (file)
         return (file->zio_getc());
+    else if (map) {
+        if (map_pos < map->size())
+            return (map->base()[map_pos++]);
+        map_eof = true;
+        return (EOF);
+    }
     else if (fp)
 #ifndef WIN32
         // The unlocked variation is faster but is not thread-safe.
@@ -355,6 +468,8 @@ sFilePtr::z_flush()
 {
     if (file)
         return (file->zio_flush());
+    else if (map)
+        return (0);
     else if (fp)
         return (fflush(fp));
     return (EOF);
@@ -365,6 +480,10 @@ sFilePtr::z_rewind()
 {
     if (file)
         file->zio_rewind();
+    else if (map) {
+        map_pos = 0;
+        map_eof = false;
+    }
     else if (fp)
         rewind(fp);
 }
@@ -374,6 +493,8 @@ sFilePtr::z_eof()
 {
     if (file)
         return (file->zio_eof());
+    else if (map)
+        return (map_eof);
     else if (fp)
         return (feof(fp));
     return (-1);
@@ -385,6 +506,8 @@ sFilePtr::z_clearerr()
     if (file)
         // this is a no-op, EOF is reset by seek
         return;
+    else if (map)
+        map_eof = false;
     else if (fp)
         clearerr(fp);
 }
@@ -398,6 +521,21 @@ sFilePtr::z_read(void *buf, size_t size, size_t nmemb)
             return (n);
         return (n/size);
     }
+    else if (map) {
+        if (!size)
+            return (0);
+        int64_t avail = map->size() - map_pos;
+        if (avail < 0)
+            avail = 0;
+        size_t n = nmemb;
+        if ((int64_t)(size*n) > avail) {
+            n = avail/size;
+            map_eof = true;
+        }
+        memcpy(buf, map->base() + map_pos, size*n);
+        map_pos += size*n;
+        return (n);
+    }
     else if (fp)
 #ifdef __linux
         // The unlocked variation is faster but is not thread-safe.
@@ -418,6 +556,8 @@ sFilePtr::z_write(const void *buf, size_t size, size_t nmemb)
             return (n);
         return (n/size);
     }
+    else if (map)
+        return (0);
     else if (fp)
         return (fwrite(buf, size, nmemb, fp));
     return (0);
@@ -434,6 +574,15 @@ sFilePtr::z_gets(char *str, int len)
         *str = 0;
         return (tstr == str && len > 0 ? 0 : tstr);
     }
+    else if (map) {
+        if (!str || len <= 0)
+            return (0);
+        char *tstr = str;
+        int c = 0;
+        while (--len > 0 && (c = z_getc()) != EOF && (*str++ = c) != '\n') ;
+        *str = 0;
+        return (tstr == str && c == EOF ? 0 : tstr);
+    }
     else if (fp)
         return (fgets(str, len, fp));
     return (0);
@@ -460,5 +609,21 @@ sFilePtr::z_set_crc(unsigned int c)
         file->zio_set_crc(c);
 }
 
+
+// If the file is memory mapped and at least sz bytes remain, return
+// a pointer to the data at the current offset, and advance the
+// offset by sz.  Otherwise return null, the caller should then read
+// the data with z_read.
+
+inline const unsigned char *
+sFilePtr::z_mapped(size_t sz)
+{
+    if (!map || map_pos + (int64_t)sz > map->size())
+        return (0);
+    const unsigned char *p = map->base() + map_pos;
+    map_pos += sz;
+    return (p);
+}
+
 #endif
 
@@ -225,6 +225,11 @@ public:
     bool useSclFuncs()                  { return (geoUseSclFuncs); }
     void setUseSclFuncs(bool b)         { geoUseSclFuncs = b; }
 
+    // Use the array-based scanline sweep for Manhattan Zlist
+    // AND-NOT and XOR operations (see Zlist::zl_sweep).
+    bool useSweepFuncs()                { return (geoUseSweepFuncs); }
+    void setUseSweepFuncs(bool b)       { geoUseSweepFuncs = b; }
+
     const sCurTx *curTx()               { return (&geoCurTform); }
     void setCurTx(sCurTx &t)            { geoCurTform = t; }
 
@@ -233,6 +238,7 @@ private:
     int geoElecRoundSides;  // Sides per 360 degrees for elec round objects
     int geoPhysRoundSides;  // Sides per 360 degrees for phys round objects
     bool geoUseSclFuncs;    // Use new scanline geometry functions.
+    bool geoUseSweepFuncs;  // Use array sweep for Manhattan booleans.
     sCurTx geoCurTform;     // "Current Transform" parameters
 
     static cGEO *instancePtr;
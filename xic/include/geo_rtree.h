@@ -559,6 +559,7 @@ struct RTree
 
 private:
     bool insert_prv(RTelem*);
+    void load_sorted(RTelem**, unsigned int);
 
     RTelem *rt_root;            // Tree root element.
     unsigned int rt_allocated;  // Element count.
@@ -95,6 +95,9 @@ enum BLCtype { BLCclip, BLCflat, BLCextend, BLCextend1,
 #define TTLnoinsert     0x2
 #define TTLjoin         0x4
 
+// Operation codes for Zlist::zl_sweep.
+enum ZLop { ZLand, ZLandnot, ZLor, ZLxor };
+
 // Deprecated in C++11
 // #define THROW_XIrt throw(XIrt)
 #define THROW_XIrt
@@ -281,6 +284,10 @@ struct Zlist
     static XIrt zl_xor(Zlist**, Zlist*);
     static XIrt zl_bloat(Zlist**, int, int);
 
+    // geo_zarray.cc
+    static bool zl_sweepable(const Zlist*, const Zlist*);
+    static XIrt zl_sweep(Zlist**, Zlist*, ZLop);
+
     Zlist *next;
     Zoid Z;
 
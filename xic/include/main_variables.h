@@ -120,6 +120,7 @@
 // #define VA_NoMergeObjects       "NoMergeObjects"
 // #define VA_NoMergePolys         "NoMergePolys"
 #define VA_NoFixRot45           "NoFixRot45"
+// #define VA_SweepBooleans        "SweepBooleans"
 
 // Side Menu Commands (see edit_variables.h)
 // #define VA_MasterMenuLength     "MasterMenuLength"
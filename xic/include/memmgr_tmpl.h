@@ -75,9 +75,32 @@ typedef unsigned long long u_int64_t;
 // Hash table depth.
 #define MMGR_HASH_DEPTH 5
 
+// Number of arenas per allocator.  Each thread allocates from one of
+// these, so threads rarely contend for a lock.
+#define MM_ARENAS 8
+
 // Error callback.
 extern void mm_err_hook(const char*, const char*);
 
+// Arena assignment, threads are assigned an arena round-robin on
+// first allocation.  With more threads than arenas, threads share an
+// arena.
+//
+#ifdef MM_PTHREAD
+extern __thread int mm_thread_arena;
+extern int mm_new_arena();
+
+inline int
+mm_arena()
+{
+    if (mm_thread_arena < 0)
+        mm_thread_arena = mm_new_arena();
+    return (mm_thread_arena);
+}
+#else
+inline int mm_arena()       { return (0); }
+#endif
+
 
 // Return the position and mask of the least significant zero bit, so
 // if v is 01001011 (base 2), the result will be 2 and the mask will
@@ -122,9 +145,16 @@ struct mmgrstat_t
             not_inuse = 0;
         }
 
-    void print(const char *nm, FILE *fp)
+    // The arena index is printed if not 0.
+    //
+    void print(const char *nm, FILE *fp, int arena = 0)
         {
-            fprintf(fp, "%-9s sz=%-3u fl=%-7u fh=%-5u nfl=%-7u nfh=%-5u "
+            char buf[64];
+            if (arena > 0) {
+                snprintf(buf, sizeof(buf), "%s/%d", nm, arena);
+                nm = buf;
+            }
+            fprintf(fp, "%-11s sz=%-3u fl=%-7u fh=%-5u nfl=%-7u nfh=%-5u "
                 "u=%-10u nu=%u\n",
                 nm, strsize, full_len, full_hash, not_full_len,
                 not_full_hash, inuse*strsize, not_inuse*strsize);
@@ -422,26 +452,30 @@ mttab_t<T>::check_rehash()
     this->tab = ntab;
 }
 
+
 #define MM_MAX_FREE_LEN     64
 
 // The "recycling mode" is now always on, but the free list length is
 // limited to MM_MAX_FREE_LEN.  Switching recycling mode on/off is not
 // possible with multi-threads.  One can call collectTrash() to clear
 // the free list if desired.
+//
+// Each arena has a free list.  An element is put on the free list of
+// the freeing thread's arena whether or not that arena owns it, so
+// freeing from a different thread costs no more than a local free.
+// The owner is found only when the element is actually returned to a
+// bank.
 
 
-// The main allocator class.
+// The allocation state of one arena.
 //
-template <class T> struct MemMgr
+template <class T> struct mmarena_t
 {
-#ifndef HAS_ATOMIC_STACK
     struct freelist_t { freelist_t *next; };
-#endif
 
-    MemMgr(const char *tname)
+    mmarena_t()
         {
             first_not_full = 0;
-            type_name = tname;
 #ifndef HAS_ATOMIC_STACK
             free_list = 0;
             free_count = 0;
@@ -451,119 +485,107 @@ template <class T> struct MemMgr
 #endif
         }
 
-    void *newElem()
+    void lock()
         {
-#ifdef HAS_ATOMIC_STACK
-            as_elt_t *e = free_stack.pop();
-            if (e)
-                return (e);
-#else
 #ifdef MM_PTHREAD
             pthread_mutex_lock(&mtx);
 #endif
-            if (free_list) {
-                void *e = free_list;
-                free_list = free_list->next;
-                free_count--;
-#ifdef MM_PTHREAD  
-                pthread_mutex_unlock(&mtx);
-#endif
-                return (e);
-            }
-#ifdef MM_PTHREAD  
+        }
+
+    void unlock()
+        {
+#ifdef MM_PTHREAD
             pthread_mutex_unlock(&mtx);
 #endif
-#endif
-            return (newElemPrv());
         }
 
-    void delElem(void *pp)
+    // Return an element from the free list, or null if empty.
+    //
+    void *pop_free()
         {
-            if (!pp)
-                return;
 #ifdef HAS_ATOMIC_STACK
-            if (free_stack.push((as_elt_t*)pp, MM_MAX_FREE_LEN))
-                return;
+            return (free_stack.pop());
 #else
-#ifdef MM_PTHREAD
-            pthread_mutex_lock(&mtx);
+            lock();
+            freelist_t *fl = free_list;
+            if (fl) {
+                free_list = fl->next;
+                free_count--;
+            }
+            unlock();
+            return (fl);
 #endif
+        }
+
+    // Add an element to the free list, return false if the list is
+    // full.
+    //
+    bool push_free(void *pp)
+        {
+#ifdef HAS_ATOMIC_STACK
+            return (free_stack.push((as_elt_t*)pp, MM_MAX_FREE_LEN));
+#else
+            lock();
+            bool ret = false;
             if (free_count < MM_MAX_FREE_LEN) {
                 freelist_t *fl = (freelist_t*)pp;
                 fl->next = free_list;
                 free_list = fl;
                 free_count++;
-#ifdef MM_PTHREAD
-                pthread_mutex_unlock(&mtx);
-#endif
-                return;
+                ret = true;
             }
-#ifdef MM_PTHREAD
-            pthread_mutex_unlock(&mtx);
-#endif
+            unlock();
+            return (ret);
 #endif
-            delElemPrv(pp);
         }
 
-    void collectTrash();        // hard-free the free list
-    void *newElemPrv();         // creator
-    void delElemPrv(void*);     // destructor
-    void stats(mmgrstat_t*);    // statistics
-    bool isAllocated(T*);       // is element allocated in this manager?
+    // Remove and return the entire free list.
+    //
+    freelist_t *take_free()
+        {
+            freelist_t *f0 = 0;
+            void *e;
+            while ((e = pop_free()) != 0) {
+                freelist_t *fl = (freelist_t*)e;
+                fl->next = f0;
+                f0 = fl;
+            }
+            return (f0);
+        }
+
+    bool is_allocated(T *x)
+        {
+            lock();
+            bool ret = (not_full_tab.find(x) || full_tab.find(x));
+            unlock();
+            return (ret);
+        }
+
+    void *new_elem(const char*);
+    bool del_elem(T*);
+    void stats(mmgrstat_t*, const char*);
 
-private:
     ebank_t<T> *first_not_full; // "current" block for allocation
-    const char *type_name;      // type name of objects
 #ifdef HAS_ATOMIC_STACK
     as_stack_t free_stack;      // "freed" objects for reuse
 #else
     freelist_t *free_list;      // "freed" objects for reuse
+    int free_count;             // number of elements in free list
 #endif
     mttab_t<T> full_tab;        // table for full banks
     mttab_t<T> not_full_tab;    // table for not full banks
-#ifndef HAS_ATOMIC_STACK
-    int free_count;             // number of elements in free list
-#endif
 #ifdef MM_PTHREAD
     pthread_mutex_t mtx;
 #endif
 };
 
 
-// Hard-free the free list.
-//
-template <class T> void
-MemMgr<T>::collectTrash()
-{
-#ifdef HAS_ATOMIC_STACK
-    as_elt_t *e0 = free_stack.list_head();
-    while (e0) {
-        as_elt_t *e = e0;
-        e0 = e0->next;
-        delElemPrv(e);
-    }
-    free_stack.clear();
-#else
-    freelist_t *fl = free_list;
-    free_list = 0;
-    free_count = 0;
-    while (fl) {
-        void* e = fl;
-        fl = fl->next;
-        delElemPrv(e);
-    }
-#endif
-}
-
-
 // Element allocator.
 //
 template <class T> void *
-MemMgr<T>::newElemPrv()
+mmarena_t<T>::new_elem(const char *type_name)
 {
-#ifdef MM_PTHREAD
-    pthread_mutex_lock(&mtx);
-#endif
+    lock();
     ebank_t<T> *bnk = first_not_full;
     if (!bnk) {
         bnk = new ebank_t<T>(type_name);
@@ -577,28 +599,22 @@ MemMgr<T>::newElemPrv()
             full_tab.insert(bnk);
             first_not_full = not_full_tab.first();
         }
-#ifdef MM_PTHREAD
-        pthread_mutex_unlock(&mtx);
-#endif
+        unlock();
         return ((T*)bnk->data + os);
     }
-#ifdef MM_PTHREAD
-    pthread_mutex_unlock(&mtx);
-#endif
+    unlock();
     mm_err_hook("full bank in not-full table, constructor failed.", type_name);
     return (0);
 }
 
 
-// Element destructor.
+// Element destructor, return false if p is not in a bank of this
+// arena.
 //
-template <class T> void
-MemMgr<T>::delElemPrv(void *pp)
+template <class T> bool
+mmarena_t<T>::del_elem(T *p)
 {
-#ifdef MM_PTHREAD
-    pthread_mutex_lock(&mtx);
-#endif
-    T *p = (T*)pp;
+    lock();
     ebank_t<T> *bnk = not_full_tab.find(p);
     if (bnk) {
         int os = bnk->bank_offset(p);
@@ -608,48 +624,41 @@ MemMgr<T>::delElemPrv(void *pp)
                 bnk = not_full_tab.remove(bnk);
                 delete bnk;
             }
-#ifdef MM_PTHREAD
-            pthread_mutex_unlock(&mtx);
-#endif
-            return;
         }
+        unlock();
+        return (true);
     }
-    else {
-        bnk = full_tab.find(p);
-        if (bnk) {
-            int os = bnk->bank_offset(p);
-            if (os >= 0) {
-                bnk->set_unused(os);
-                full_tab.remove(bnk);
-                not_full_tab.insert(bnk);
-                ebank_t<T> *nf = not_full_tab.first();
-                if (nf != first_not_full) {
-                    bnk = first_not_full;
-                    if (bnk && bnk->is_empty()) {
-                        bnk = not_full_tab.remove(bnk);
-                        delete bnk;
-                    }
-                    first_not_full = nf;
+    bnk = full_tab.find(p);
+    if (bnk) {
+        int os = bnk->bank_offset(p);
+        if (os >= 0) {
+            bnk->set_unused(os);
+            full_tab.remove(bnk);
+            not_full_tab.insert(bnk);
+            ebank_t<T> *nf = not_full_tab.first();
+            if (nf != first_not_full) {
+                bnk = first_not_full;
+                if (bnk && bnk->is_empty()) {
+                    bnk = not_full_tab.remove(bnk);
+                    delete bnk;
                 }
-#ifdef MM_PTHREAD
-                pthread_mutex_unlock(&mtx);
-#endif
-                return;
+                first_not_full = nf;
             }
         }
+        unlock();
+        return (true);
     }
-#ifdef MM_PTHREAD
-    pthread_mutex_unlock(&mtx);
-#endif
-    mm_err_hook("bad pointer passed to delElem (not in banks)!", type_name);
+    unlock();
+    return (false);
 }
 
 
-// Statistics.
+// Statistics, these are added to the counts in st.
 //
 template <class T> void
-MemMgr<T>::stats(mmgrstat_t *st)
+mmarena_t<T>::stats(mmgrstat_t *st, const char *type_name)
 {
+    lock();
     st->strsize = sizeof(T);
     if (full_tab.tab) {
         for (unsigned int i = 0; i <= full_tab.hashmask; i++) {
@@ -659,12 +668,11 @@ MemMgr<T>::stats(mmgrstat_t *st)
             }
         }
     }
-    st->full_len = full_tab.count;
-    st->full_hash = full_tab.hashmask + 1;
-    st->not_full_len = not_full_tab.count;
-    st->not_full_hash = not_full_tab.hashmask + 1;
-    st->inuse = 2*MM_HBITS*st->full_len;
-    st->not_inuse = 0;
+    st->full_len += full_tab.count;
+    st->full_hash += full_tab.hashmask + 1;
+    st->not_full_len += not_full_tab.count;
+    st->not_full_hash += not_full_tab.hashmask + 1;
+    st->inuse += MM_BANKSZ*MM_HBITS*full_tab.count;
 
     if (not_full_tab.tab) {
         for (unsigned int i = 0; i <= not_full_tab.hashmask; i++) {
@@ -679,13 +687,126 @@ MemMgr<T>::stats(mmgrstat_t *st)
             }
         }
     }
+    unlock();
+}
+
+
+// The main allocator class.
+//
+template <class T> struct MemMgr
+{
+    MemMgr(const char *tname)
+        {
+            type_name = tname;
+        }
+
+    void *newElem()
+        {
+            mmarena_t<T> *ar = arenas + mm_arena();
+            void *e = ar->pop_free();
+            if (e)
+                return (e);
+            return (ar->new_elem(type_name));
+        }
+
+    void delElem(void *pp)
+        {
+            if (!pp)
+                return;
+            if (arenas[mm_arena()].push_free(pp))
+                return;
+            delElemPrv(pp);
+        }
+
+    void collectTrash();        // hard-free the free lists
+    void delElemPrv(void*);     // destructor
+    void stats(mmgrstat_t*, int = -1);  // statistics
+    void print_stats(FILE*, int*, int*);
+    bool isAllocated(T*);       // is element allocated in this manager?
+
+private:
+    const char *type_name;      // type name of objects
+    mmarena_t<T> arenas[MM_ARENAS];
+};
+
+
+// Hard-free the free lists.
+//
+template <class T> void
+MemMgr<T>::collectTrash()
+{
+    for (int i = 0; i < MM_ARENAS; i++) {
+        typename mmarena_t<T>::freelist_t *fl = arenas[i].take_free();
+        while (fl) {
+            void *e = fl;
+            fl = fl->next;
+            delElemPrv(e);
+        }
+    }
+}
+
+
+// Element destructor.  The element is most likely in the caller's
+// arena, which is checked first.
+//
+template <class T> void
+MemMgr<T>::delElemPrv(void *pp)
+{
+    T *p = (T*)pp;
+    int a0 = mm_arena();
+    for (int i = 0; i < MM_ARENAS; i++) {
+        if (arenas[(a0 + i) % MM_ARENAS].del_elem(p))
+            return;
+    }
+    mm_err_hook("bad pointer passed to delElem (not in banks)!", type_name);
+}
+
+
+// Statistics for the given arena, or all arenas if negative.
+//
+template <class T> void
+MemMgr<T>::stats(mmgrstat_t *st, int arena)
+{
+    *st = mmgrstat_t();
+    if (arena >= MM_ARENAS)
+        return;
+    if (arena >= 0) {
+        arenas[arena].stats(st, type_name);
+        return;
+    }
+    for (int i = 0; i < MM_ARENAS; i++)
+        arenas[i].stats(st, type_name);
+}
+
+
+// Print statistics for each arena that has allocated banks, adding
+// byte counts to the passed totals.  Arena 0 is always printed.
+//
+template <class T> void
+MemMgr<T>::print_stats(FILE *fp, int *inuse, int *not_inuse)
+{
+    for (int i = 0; i < MM_ARENAS; i++) {
+        mmgrstat_t st;
+        stats(&st, i);
+        if (i > 0 && !st.full_len && !st.not_full_len)
+            continue;
+        st.print(type_name, fp, i);
+        if (inuse)
+            *inuse += st.inuse*st.strsize;
+        if (not_inuse)
+            *not_inuse += st.not_inuse*st.strsize;
+    }
 }
 
 
 template <class T> bool
 MemMgr<T>::isAllocated(T *x)
 {
-    return (not_full_tab.find(x) || full_tab.find(x));
+    for (int i = 0; i < MM_ARENAS; i++) {
+        if (arenas[i].is_allocated(x))
+            return (true);
+    }
+    return (false);
 }
 
 #endif
@@ -55,6 +55,23 @@ mm_err_hook(const char *s, const char *type_name)
 }
 
 
+#ifdef MM_PTHREAD
+
+// Arena index of the current thread, -1 if not yet assigned.
+__thread int mm_thread_arena = -1;
+
+// Return the next arena index, arenas are handed out round-robin.
+//
+int
+mm_new_arena()
+{
+    static int arena_cnt;
+    return (__sync_fetch_and_add(&arena_cnt, 1) % MM_ARENAS);
+}
+
+#endif
+
+
 //-----------------------------------------------------------------------------
 // cCDmmgr:
 // Memory management of CDo and derived, CDs, CDm, CDol, CDcl, and SymTabEnt.
@@ -127,77 +144,18 @@ cCDmmgr::stats(int *inuse, int *not_inuse)
 #else
     printf("Atomic free list: no\n");
 #endif
-
-    mmgrstat_t st;
-    CDo_db.stats(&st);
-    st.print("CDo", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDpo_db.stats(&st);
-    st.print("CDpo", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDw_db.stats(&st);
-    st.print("CDw", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDla_db.stats(&st);
-    st.print("CDla", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDc_db.stats(&st);
-    st.print("CDc", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDs_db.stats(&st);
-    st.print("CDs", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDm_db.stats(&st);
-    st.print("CDm", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDol_db.stats(&st);
-    st.print("CDol", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    CDcl_db.stats(&st);
-    st.print("CDcl", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    SymTabEnt_db.stats(&st);
-    st.print("SymTabEnt", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
+    printf("Arenas: %d\n", MM_ARENAS);
+
+    CDo_db.print_stats(stdout, inuse, not_inuse);
+    CDpo_db.print_stats(stdout, inuse, not_inuse);
+    CDw_db.print_stats(stdout, inuse, not_inuse);
+    CDla_db.print_stats(stdout, inuse, not_inuse);
+    CDc_db.print_stats(stdout, inuse, not_inuse);
+    CDs_db.print_stats(stdout, inuse, not_inuse);
+    CDm_db.print_stats(stdout, inuse, not_inuse);
+    CDol_db.print_stats(stdout, inuse, not_inuse);
+    CDcl_db.print_stats(stdout, inuse, not_inuse);
+    SymTabEnt_db.print_stats(stdout, inuse, not_inuse);
 }
 
 
@@ -78,6 +78,7 @@ cDisplay::cDisplay()
     d_phys_prop_size        = 0;
     d_term_text_size        = 0;
     d_term_mark_size        = 0;
+    d_db_generation         = 0;
 
     d_phys_char_width       = 0.0;
     d_phys_char_height      = 0.0;
@@ -269,6 +269,7 @@ WindowDesc::RefreshList(const Blist *list)
 void
 WindowDesc::Redisplay(const BBox *AOI)
 {
+    check_image_cache(AOI);
     if (DSP()->NoGraphics() || DSP()->NoRedisplay())
         return;
     if (DSP()->SlowMode()) {
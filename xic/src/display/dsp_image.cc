@@ -80,6 +80,22 @@ cDisplay::CreateImage(cCHD *chd, const char *cellname, BBox *AOI,
     im->set_own_data();
     return (im);
 }
+
+
+// Free the saved full-window images of all windows.  This is called
+// when a cell is cleared or destroyed, as when it is reread from a
+// file.  The database generation is advanced as well, so that no
+// image saved before the change can be used.
+//
+void
+cDisplay::ClearImageCaches()
+{
+    d_db_generation++;
+    for (int i = 0; i < DSP_NUMWINS; i++) {
+        if (d_windows[i])
+            d_windows[i]->ClearImageCache();
+    }
+}
 // End of cDisplay functions.
 
 
@@ -192,6 +208,16 @@ WindowDesc::CreateChdImage(cCHD *chd, const char *cellname, const BBox *AOI,
 }
 
 
+// Free the saved full-window images.
+//
+void
+WindowDesc::ClearImageCache()
+{
+    wImgElt::destroy(w_imgcache);
+    w_imgcache = 0;
+}
+
+
 // Private function to do the work in CHD image creation.
 //
 int
@@ -861,9 +887,160 @@ WindowDesc::redisplay_cddb_zimg_rc(CDs *sdesc, int hierlev,
     delete [] invpts;
     return (numgeom);
 }
+
+
+// If an image of the present full-window view has been saved, move
+// it to the front of the list and return an image struct that
+// references the saved data, and set numgeom to the object count
+// when the image was rendered.  Return null otherwise.
+//
+GRimage *
+WindowDesc::find_cached_image(int *numgeom)
+{
+    int explev = w_attributes.expand_level(w_mode);
+    wImgElt *ep = 0;
+    for (wImgElt *e = w_imgcache; e; ep = e, e = e->next) {
+        if (e->BB != w_window || e->ratio != w_ratio)
+            continue;
+        if ((int)e->width != w_width || (int)e->height != w_height)
+            continue;
+        if (e->topname != w_top_cellname || e->curname != w_cur_cellname)
+            continue;
+        if (e->mode != w_mode || e->displflag != w_displflag ||
+                e->explev != explev)
+            continue;
+        if (e->dbgen != DSP()->DbGeneration())
+            continue;
+
+        if (ep) {
+            ep->next = e->next;
+            e->next = w_imgcache;
+            w_imgcache = e;
+        }
+        if (numgeom)
+            *numgeom = e->numgeom;
+        return (new GRimage(e->width, e->height, e->data, true));
+    }
+    return (0);
+}
+
+
+// Save a copy of the full-window image just rendered, keyed by the
+// present view.  The least recently used image is freed if the list
+// is full.
+//
+void
+WindowDesc::save_cached_image(const GRimage *im, int numgeom)
+{
+    if (!im || !im->data())
+        return;
+    if ((int)im->width() != w_width || (int)im->height() != w_height)
+        return;
+
+    w_imgcache = new wImgElt(im->data(), im->width(), im->height(),
+        w_imgcache);
+    w_imgcache->BB = w_window;
+    w_imgcache->ratio = w_ratio;
+    w_imgcache->topname = w_top_cellname;
+    w_imgcache->curname = w_cur_cellname;
+    w_imgcache->displflag = w_displflag;
+    w_imgcache->explev = w_attributes.expand_level(w_mode);
+    w_imgcache->numgeom = numgeom;
+    w_imgcache->dbgen = DSP()->DbGeneration();
+    w_imgcache->mode = w_mode;
+
+    int cnt = 1;
+    for (wImgElt *e = w_imgcache; e; e = e->next, cnt++) {
+        if (cnt == DSP_IMGCACHE_SIZE) {
+            wImgElt::destroy(e->next);
+            e->next = 0;
+            break;
+        }
+    }
+}
+
+
+// Called on each redisplay request.  The saved images remain valid
+// across view changes only.  A full-window redisplay that is not the
+// result of a view change indicates a change in display attributes,
+// so all images are freed.  A partial redisplay follows a database
+// change within AOI.  Images that overlap AOI are freed from this
+// and similar windows, other windows may show the changed objects
+// in some other context so their images are freed.
+//
+// A view change can also come with a database change, as when a
+// cell is reread and the full view shown.  This is not seen here,
+// such changes advance the database generation that is part of the
+// image key, and clearing or destroying a cell frees all images (see
+// cDisplay::ClearImageCaches).
+//
+void
+WindowDesc::check_image_cache(const BBox *AOI)
+{
+    bool view_change = w_view_change;
+    w_view_change = false;
+    if (!AOI || *AOI == w_window) {
+        if (!view_change)
+            ClearImageCache();
+        return;
+    }
+    for (int i = 0; i < DSP_NUMWINS; i++) {
+        WindowDesc *wd = DSP()->Window(i);
+        if (!wd || !wd->w_imgcache)
+            continue;
+        if (wd == this || wd->IsSimilar(this))
+            wd->invalidate_image_cache(AOI);
+        else
+            wd->ClearImageCache();
+    }
+}
+
+
+// Free the saved images that overlap AOI, or that show a different
+// hierarchy than the present one, since AOI is not meaningful there.
+//
+void
+WindowDesc::invalidate_image_cache(const BBox *AOI)
+{
+    wImgElt *ep = 0, *en;
+    for (wImgElt *e = w_imgcache; e; e = en) {
+        en = e->next;
+        if (e->topname != w_top_cellname || e->mode != w_mode ||
+                e->BB.intersect(AOI, true)) {
+            if (ep)
+                ep->next = en;
+            else
+                w_imgcache = en;
+            delete e;
+            continue;
+        }
+        ep = e;
+    }
+}
 // End of WindowDesc functions.
 
 
+wImgElt::wImgElt(const unsigned int *d, unsigned int w, unsigned int h,
+    wImgElt *nx)
+{
+    ratio = 0.0;
+    topname = 0;
+    curname = 0;
+    unsigned int sz = w*h;
+    data = new unsigned int[sz];
+    memcpy(data, d, sz*sizeof(unsigned int));
+    next = nx;
+    width = w;
+    height = h;
+    displflag = 0;
+    explev = 0;
+    numgeom = 0;
+    dbgen = 0;
+    mode = Physical;
+}
+// End of wImgElt functions.
+
+
 //-----------------------------------------------------------------------------
 // ximg_backend
 //
@@ -139,7 +139,16 @@ WindowDesc::redisplay_geom(const BBox *AOI, bool no_clear)
 
     int numgeom = 0;
     if (w_using_image) {
-        GRimage *image = CreateImage(AOI, &numgeom);
+        // When redrawing the full window, an image of the same view
+        // may have been saved, which avoids traversing the database
+        // when returning to a previous view.
+        bool fullwin = (w_dbtype == WDcddb && w_clip_rect == Viewport());
+        GRimage *image = fullwin ? find_cached_image(&numgeom) : 0;
+        if (!image) {
+            image = CreateImage(AOI, &numgeom);
+            if (image && fullwin && !DSP()->Interrupt())
+                save_cached_image(image, numgeom);
+        }
         if (image) {
             w_draw->DisplayImage(image, w_clip_rect.left, w_clip_rect.top,
                 w_clip_rect.width() + 1, abs(w_clip_rect.height()) + 1);
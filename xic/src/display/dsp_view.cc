@@ -332,6 +332,7 @@ WindowDesc::InitWindow(int x, int y, double width)
 
     w_ratio = ((double)w_width)/width;
     w_views.add_hist(&w_window);
+    w_view_change = true;
     DSP()->window_view_change(this);
 
     // Update the previous subwindow location in main window.
@@ -134,6 +134,7 @@ WindowDesc::WindowDesc()
     w_dbcellname        = 0;
 
     w_rgbimg            = 0;
+    w_imgcache          = 0;
 
     w_mode              = Physical;
     w_displflag         = 0;
@@ -149,6 +150,7 @@ WindowDesc::WindowDesc()
     w_using_pixmap      = false;
     w_using_image       = false;
     w_old_image         = false;
+    w_view_change       = false;
 
     w_windowid          = 0;
     w_accum_mode        = WDaccumDone;
@@ -184,6 +186,7 @@ WindowDesc::~WindowDesc()
 
     delete w_cache;
     delete w_rgbimg;
+    wImgElt::destroy(w_imgcache);
     delete w_proxy;
 }
 
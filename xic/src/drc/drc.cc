@@ -71,6 +71,7 @@ cDRC::cDRC()
     drc_abort           = false;
 
     drc_grid_size       = 0;
+    drc_grid_jobs       = DRC_PART_JOBS_MIN;
 
     drc_obj_count       = 0;
     drc_err_count       = 0;
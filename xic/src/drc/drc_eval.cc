@@ -602,6 +602,66 @@ cDRC::batchTest(const BBox *AOI, FILE *fp, sLstr *lstr, BBox *errBB,
 }
 
 
+// Description of the partitioning grid used by gridBatchTest and
+// chdGridBatchTest.  Regions are numbered row-wise from the lower-left
+// corner.
+//
+struct DRCgrid
+{
+    DRCgrid(const BBox &BB, int gridsize, int bloat)
+        {
+            g_BB = BB;
+            g_chd = 0;
+            g_cellname = 0;
+            g_topname = 0;
+            g_nx = 1;
+            g_ny = 1;
+            g_gsx = BB.width();
+            g_gsy = BB.height();
+            if (gridsize > 0) {
+                g_nx = BB.width()/gridsize + (BB.width()%gridsize != 0);
+                g_ny = BB.height()/gridsize + (BB.height()%gridsize != 0);
+                g_gsx = gridsize;
+                g_gsy = gridsize;
+            }
+            g_bloat = bloat;
+            g_flatten = false;
+        }
+
+    int nvals()                 const { return (g_nx*g_ny); }
+
+    // Return the area of region n.
+    BBox region(int n) const
+        {
+            int cx = g_BB.left + (n % g_nx)*g_gsx;
+            int cy = g_BB.bottom + (n / g_nx)*g_gsy;
+            BBox cBB(cx, cy, cx + g_gsx, cy + g_gsy);
+            if (cBB.right > g_BB.right)
+                cBB.right = g_BB.right;
+            if (cBB.top > g_BB.top)
+                cBB.top = g_BB.top;
+            return (cBB);
+        }
+
+    BBox g_BB;                  // Total area.
+    cCHD *g_chd;                // Geometry source, if not in memory.
+    const char *g_cellname;     // CHD cell name to read.
+    CDcellName g_topname;       // Name of top cell read from CHD.
+    int g_nx, g_ny;             // Grid dimensions.
+    int g_gsx, g_gsy;           // Region size.
+    int g_bloat;                // Halo when reading regions from CHD.
+    bool g_flatten;             // Flatten when reading from CHD.
+};
+
+
+// Temporary cell table used by chdGridBatchTest.
+#define STNAME "drc_tmp_table"
+
+// Prefix for the status line that ends the region files written by
+// the grid_fork_regions worker processes.
+#define DRC_GRID_CTL "#@drcgrid"
+
+
 XIrt
 cDRC::gridBatchTest(const BBox *AOI, FILE *outfp)
 {
@@ -618,22 +678,9 @@ cDRC::gridBatchTest(const BBox *AOI, FILE *outfp)
     if (!update_rule_disable())
         return (XIbad);
 
-    BBox coarseBB = AOI ? *AOI : *cursdp->BB();
-
-    int nxc = 1, nyc = 1;
-    int gsx = coarseBB.width();
-    int gsy = coarseBB.height();
-    if (gridsize > 0) {
-        nxc = coarseBB.width()/gridsize + (coarseBB.width()%gridsize != 0);
-        nyc = coarseBB.height()/gridsize + (coarseBB.height()%gridsize != 0);
-        gsx = gridsize;
-        gsy = gridsize;
-    }
-    int nvals = nxc*nyc;
-
-    int bloat_val = haloWidth();
+    DRCgrid grid(AOI ? *AOI : *cursdp->BB(), gridsize, haloWidth());
+    int nvals = grid.nvals();
 
-    int regcnt = 0;
     char *outfile = 0;
     FILE *fp = 0;
     if (!outfp) {
@@ -701,40 +748,8 @@ cDRC::gridBatchTest(const BBox *AOI, FILE *outfp)
         tot_errs += drc_err_count;
     }
 
-    XIrt ret = XIok;
-    for (int ic = 0; ic < nyc; ic++) {
-        for (int jc = 0; jc < nxc; jc++) {
-            int cur_cx = coarseBB.left + jc*gsx;
-            int cur_cy = coarseBB.bottom + ic*gsy;
-            BBox coarse_cBB(cur_cx, cur_cy,
-                cur_cx + gsx, cur_cy + gsy);
-            if (coarse_cBB.right > coarseBB.right)
-                coarse_cBB.right = coarseBB.right;
-            if (coarse_cBB.top > coarseBB.top)
-                coarse_cBB.top = coarseBB.top;
-
-            char fbbuf[64];
-            sprintf(fbbuf, "Checking region %d of %d  ", ic*nxc + jc + 1,
-                nvals);
-            PL()->ShowPromptV("Starting %d of %d.", ic*nxc + jc + 1, nvals);
-
-            BBox tcBB(coarse_cBB);
-            tcBB.bloat(bloat_val);
-
-            fprintf(fp, "# REGION %d (%g,%g %g,%g)\n", regcnt,
-                MICRONS(coarse_cBB.left), MICRONS(coarse_cBB.bottom),
-                MICRONS(coarse_cBB.right), MICRONS(coarse_cBB.top));
-            ret = batchTest(&coarse_cBB, fp, 0, 0, nvals == 1 ? 0 : fbbuf);
-            regcnt++;
-
-            tot_errs += drc_err_count;
-            tot_checked += drc_num_checked;
+    XIrt ret = grid_regions(&grid, fp, &tot_errs, &tot_checked);
 
-            if (ret != XIok)
-                goto done;
-        }
-    }
-done:
     drc_start_time = start_time;
     drc_err_count = tot_errs;
     drc_num_checked = tot_checked;
@@ -782,22 +797,13 @@ cDRC::chdGridBatchTest(cCHD *chd, const char *cellname, const BBox *AOI,
     }
     chd->setBoundaries(top);
 
-    BBox coarseBB = AOI ? *AOI : *top->get_bb();
-
-    int nxc = 1, nyc = 1;
-    int gsx = coarseBB.width();
-    int gsy = coarseBB.height();
-    if (gridsize > 0) {
-        nxc = coarseBB.width()/gridsize + (coarseBB.width()%gridsize != 0);
-        nyc = coarseBB.height()/gridsize + (coarseBB.height()%gridsize != 0);
-        gsx = gridsize;
-        gsy = gridsize;
-    }
-    int nvals = nxc*nyc;
+    DRCgrid grid(AOI ? *AOI : *top->get_bb(), gridsize, haloWidth());
+    grid.g_chd = chd;
+    grid.g_cellname = cellname;
+    grid.g_topname = top->get_name();
+    grid.g_flatten = flatten;
+    int nvals = grid.nvals();
 
-    int bloat_val = haloWidth();
-
-    int regcnt = 0;
     char *outfile = 0;
     FILE *fp = 0;
     if (!outfp) {
@@ -828,7 +834,6 @@ cDRC::chdGridBatchTest(cCHD *chd, const char *cellname, const BBox *AOI,
 
     char *st_old = lstring::copy(CDcdb()->tableName());
 
-#define STNAME "drc_tmp_table"
     if (CDcdb()->findTable(STNAME)) {
         CDcdb()->switchTable(STNAME);
         CDcdb()->destroyTable(false);
@@ -840,66 +845,8 @@ cDRC::chdGridBatchTest(cCHD *chd, const char *cellname, const BBox *AOI,
     drc_doing_grid = (nvals > 1);
     drc_with_chd = true;
 
-    XIrt ret = XIok;
-    for (int ic = 0; ic < nyc; ic++) {
-        for (int jc = 0; jc < nxc; jc++) {
-            int cur_cx = coarseBB.left + jc*gsx;
-            int cur_cy = coarseBB.bottom + ic*gsy;
-            BBox coarse_cBB(cur_cx, cur_cy,
-                cur_cx + gsx, cur_cy + gsy);
-            if (coarse_cBB.right > coarseBB.right)
-                coarse_cBB.right = coarseBB.right;
-            if (coarse_cBB.top > coarseBB.top)
-                coarse_cBB.top = coarseBB.top;
-
-            char fbbuf[64];
-            sprintf(fbbuf, "Checking region %d of %d  ", ic*nxc + jc + 1,
-                nvals);
-            PL()->ShowPromptV("Starting %d of %d.", ic*nxc + jc + 1, nvals);
-
-            BBox tcBB(coarse_cBB);
-            tcBB.bloat(bloat_val);
-
-            CDcdb()->switchTable(STNAME);
-            bool ne = CD()->IsNoElectrical();
-            CD()->SetNoElectrical(true);
-            FIOcvtPrms prms;
-            prms.set_allow_layer_mapping(true);
-            prms.set_use_window(true);
-            prms.set_window(&tcBB);
-            prms.set_flatten(flatten);
-            prms.set_clip(true);
-            OItype oiret = chd->write(cellname, &prms, true);
-            CD()->SetNoElectrical(ne);
-            if (oiret != OIok) {
-                Errs()->add_error("chdGridBatchTest: read failed at %d,%d.",
-                    cur_cx, cur_cy);
-                if (oiret == OIaborted)
-                    ret = XIintr;
-                else
-                    ret = XIbad;
-                goto done;
-            }
-            CDcellName tname = DSP()->MainWdesc()->CurCellName();
-            DSP()->MainWdesc()->SetCurCellName(top->get_name());
-
-            fprintf(fp, "# REGION %d (%g,%g %g,%g)\n", regcnt,
-                MICRONS(coarse_cBB.left), MICRONS(coarse_cBB.bottom),
-                MICRONS(coarse_cBB.right), MICRONS(coarse_cBB.top));
+    XIrt ret = grid_regions(&grid, fp, &tot_errs, &tot_checked);
 
-            ret = batchTest(&coarse_cBB, fp, 0, 0, nvals == 1 ? 0 : fbbuf);
-            CDcdb()->destroyTable(false);
-            DSP()->SetCurCellName(tname);
-            regcnt++;
-
-            tot_errs += drc_err_count;
-            tot_checked += drc_num_checked;
-
-            if (ret != XIok)
-                goto done;
-        }
-    }
-done:
     drc_start_time = start_time;
     drc_err_count = tot_errs;
     drc_num_checked = tot_checked;
@@ -919,6 +866,270 @@ done:
 }
 
 
+// Private function to check region n of the grid, writing the region
+// header, error records, and a timing comment to fp.  On return,
+// drc_err_count and drc_num_checked contain the region counts.  When
+// working from a CHD, the region (plus halo) is read into a temporary
+// table for the check.
+//
+XIrt
+cDRC::grid_region(const DRCgrid *grid, int n, FILE *fp)
+{
+    BBox cBB(grid->region(n));
+    int nvals = grid->nvals();
+
+    char fbbuf[64];
+    sprintf(fbbuf, "Checking region %d of %d  ", n + 1, nvals);
+    PL()->ShowPromptV("Starting %d of %d.", n + 1, nvals);
+
+    unsigned long t0 = Timer()->elapsed_msec();
+    CDcellName tname = 0;
+    if (grid->g_chd) {
+        BBox tcBB(cBB);
+        tcBB.bloat(grid->g_bloat);
+
+        CDcdb()->switchTable(STNAME);
+        bool ne = CD()->IsNoElectrical();
+        CD()->SetNoElectrical(true);
+        FIOcvtPrms prms;
+        prms.set_allow_layer_mapping(true);
+        prms.set_use_window(true);
+        prms.set_window(&tcBB);
+        prms.set_flatten(grid->g_flatten);
+        prms.set_clip(true);
+        OItype oiret = grid->g_chd->write(grid->g_cellname, &prms, true);
+        CD()->SetNoElectrical(ne);
+        if (oiret != OIok) {
+            Errs()->add_error("chdGridBatchTest: read failed at %d,%d.",
+                cBB.left, cBB.bottom);
+            drc_err_count = 0;
+            drc_num_checked = 0;
+            return (oiret == OIaborted ? XIintr : XIbad);
+        }
+        tname = DSP()->MainWdesc()->CurCellName();
+        DSP()->MainWdesc()->SetCurCellName(grid->g_topname);
+    }
+
+    fprintf(fp, "# REGION %d (%g,%g %g,%g)\n", n,
+        MICRONS(cBB.left), MICRONS(cBB.bottom),
+        MICRONS(cBB.right), MICRONS(cBB.top));
+
+    XIrt ret = batchTest(&cBB, fp, 0, 0, nvals == 1 ? 0 : fbbuf);
+    if (grid->g_chd) {
+        CDcdb()->destroyTable(false);
+        DSP()->SetCurCellName(tname);
+    }
+    fprintf(fp, "# REGION %d: %.3f sec, %u objects checked, %u errors\n", n,
+        1e-3*(Timer()->elapsed_msec() - t0), drc_num_checked, drc_err_count);
+    return (ret);
+}
+
+
+// Private function to check each region of the grid in order,
+// accumulating the error and checked object counts.  If the
+// DrcPartitionJobs variable calls for more than one process, the
+// regions are checked in parallel.
+//
+XIrt
+cDRC::grid_regions(const DRCgrid *grid, FILE *fp, unsigned int *errs,
+    unsigned int *checked)
+{
+#ifndef WIN32
+    XIrt fret;
+    if (drc_grid_jobs > 1 && grid->nvals() > 1 &&
+            grid_fork_regions(grid, fp, errs, checked, &fret))
+        return (fret);
+#endif
+
+    int nvals = grid->nvals();
+    XIrt ret = XIok;
+    for (int n = 0; n < nvals; n++) {
+        ret = grid_region(grid, n, fp);
+        *errs += drc_err_count;
+        *checked += drc_num_checked;
+        if (ret != XIok)
+            break;
+    }
+    return (ret);
+}
+
+
+#ifndef WIN32
+
+// Private function to check the grid regions concurrently in
+// drc_grid_jobs forked processes.  Worker w checks regions w,
+// w + njobs, ..., writing the output for each region to a temporary
+// file, which is terminated with a status line.  The workers inherit
+// the database copy-on-write, so nothing is reread unless working
+// from a CHD, in which case each worker uses its own temporary table.
+//
+// When the workers are done, the region files are added to fp in
+// region order, so that the log is the same as from a sequential
+// run.  As in the sequential case, output stops after a region that
+// failed or was interrupted.  The return status is passed in retp.
+// False is returned if the workers could not be started, in which
+// case nothing has been written.
+//
+// Processes are used rather than threads since the state of a check
+// (error list, counts, current object, error file) is kept in the
+// cDRC singleton, derived layers are evaluated into the shared layer
+// table with the common drc_variables context, and the error log and
+// the static transform registers have no locking.
+//
+bool
+cDRC::grid_fork_regions(const DRCgrid *grid, FILE *fp, unsigned int *errs,
+    unsigned int *checked, XIrt *retp)
+{
+    int nvals = grid->nvals();
+    int njobs = drc_grid_jobs;
+    if (njobs > nvals)
+        njobs = nvals;
+
+    char *base = filestat::make_temp("drg");
+    char *fn = new char[strlen(base) + 16];
+    fflush(fp);
+
+    int *pids = new int[njobs];
+    for (int w = 0; w < njobs; w++) {
+        int pid = fork();
+        if (pid == 0) {
+            // In worker, halt graphics and detach from the terminal.
+            XM()->SetRunMode(ModeBackground);
+            dspPkgIf()->ReinitNoGraphics();
+            int fd = open("/dev/null", O_RDWR);
+            if (fd >= 0) {
+                dup2(fd, 0);
+                dup2(fd, 1);
+                dup2(fd, 2);
+                if (fd > 2)
+                    close(fd);
+            }
+
+            for (int n = w; n < nvals; n += njobs) {
+                sprintf(fn, "%s.%d", base, n);
+                FILE *rfp = fopen(fn, "w");
+                if (!rfp)
+                    break;
+                XIrt ret = grid_region(grid, n, rfp);
+                fprintf(rfp, "%s %d %u %u\n", DRC_GRID_CTL, ret,
+                    drc_err_count, drc_num_checked);
+                fclose(rfp);
+                if (ret != XIok)
+                    break;
+            }
+            _exit(0);  // gtk error if exit() called due to atexit()
+        }
+        if (pid < 0) {
+            // Can't fork, kill any workers started and let the caller
+            // run sequentially.
+            for (int i = 0; i < w; i++) {
+                kill(pids[i], SIGKILL);
+                waitpid(pids[i], 0, 0);
+            }
+            for (int n = 0; n < nvals; n++) {
+                sprintf(fn, "%s.%d", base, n);
+                unlink(fn);
+            }
+            delete [] pids;
+            delete [] fn;
+            delete [] base;
+            return (false);
+        }
+        pids[w] = pid;
+    }
+
+    if (XM()->RunMode() == ModeNormal)
+        PL()->ShowPromptV("Checking %d regions using %d processes.", nvals,
+            njobs);
+
+    // Wait for the workers.  The SIGCHLD handler may reap a worker
+    // before we do, so ECHILD also indicates completion.
+    XIrt ret = XIok;
+    int nleft = njobs;
+    for (;;) {
+        for (int w = 0; w < njobs; w++) {
+            if (pids[w] <= 0)
+                continue;
+            int status;
+            int p = waitpid(pids[w], &status, WNOHANG);
+            if (p == pids[w] || (p < 0 && errno == ECHILD)) {
+                pids[w] = 0;
+                nleft--;
+            }
+        }
+        if (!nleft)
+            break;
+        if (ret == XIok) {
+            dspPkgIf()->CheckForInterrupt();
+            if (drc_abort || XM()->ConfirmAbort()) {
+                drc_abort = false;
+                for (int w = 0; w < njobs; w++) {
+                    if (pids[w] > 0)
+                        kill(pids[w], SIGTERM);
+                }
+                ret = XIintr;
+            }
+        }
+        cTimer::milli_sleep(50);
+    }
+    delete [] pids;
+
+    // Merge the region files, in order.
+    bool done = false;
+    for (int n = 0; n < nvals; n++) {
+        sprintf(fn, "%s.%d", base, n);
+        FILE *rfp = done ? 0 : fopen(fn, "r");
+        bool gotctl = false;
+        if (rfp) {
+            char buf[512];
+            bool bol = true;
+            int rret = XIbad;
+            unsigned int rerrs = 0, rchecked = 0;
+            while (fgets(buf, 512, rfp) != 0) {
+                if (bol && lstring::prefix(DRC_GRID_CTL, buf)) {
+                    if (sscanf(buf + strlen(DRC_GRID_CTL), "%d %u %u", &rret,
+                            &rerrs, &rchecked) == 3)
+                        gotctl = true;
+                }
+                else
+                    fputs(buf, fp);
+                bol = (strchr(buf, '\n') != 0);
+            }
+            fclose(rfp);
+            if (gotctl) {
+                *errs += rerrs;
+                *checked += rchecked;
+                if (rret != XIok) {
+                    if (ret == XIok) {
+                        if (rret == XIbad)
+                            Errs()->add_error(
+                                "gridBatchTest: check failed in region %d.",
+                                n);
+                        ret = (XIrt)rret;
+                    }
+                    done = true;
+                }
+            }
+        }
+        if (!gotctl && !done) {
+            if (ret == XIok) {
+                Errs()->add_error(
+                    "gridBatchTest: no result from region %d.", n);
+                ret = XIbad;
+            }
+            done = true;
+        }
+        unlink(fn);
+    }
+    delete [] fn;
+    delete [] base;
+    *retp = ret;
+    return (true);
+}
+
+#endif
+
+
 // As for batchTest, but act on a list (slist) of objects (no subcells
 // allowed).
 //
@@ -286,6 +286,27 @@ namespace {
         CDvdb()->registerPostFunc(postrun);
         return (true);
     }
+
+    bool
+    evDrcPartitionJobs(const char *vstring, bool set)
+    {
+        if (set) {
+            int i;
+            if (str_to_int(&i, vstring) &&
+                    i >= DRC_PART_JOBS_MIN && i <= DRC_PART_JOBS_MAX)
+                DRC()->setGridJobs(i);
+            else {
+                Log()->ErrorLogV(mh::Variables,
+                    "Incorrect DrcPartitionJobs: must be %d-%d.",
+                    DRC_PART_JOBS_MIN, DRC_PART_JOBS_MAX);
+                return (false);
+            }
+        }
+        else
+            DRC()->setGridJobs(DRC_PART_JOBS_MIN);
+        CDvdb()->registerPostFunc(postrun);
+        return (true);
+    }
 }
 
 
@@ -324,5 +345,6 @@ cDRC::setupVariables()
     vsetup(VA_DrcChdName,           S,  evDrcChd);
     vsetup(VA_DrcChdCell,           S,  evDrcChd);
     vsetup(VA_DrcPartitionSize,     S,  evDrcPartitionSize);
+    vsetup(VA_DrcPartitionJobs,     S,  evDrcPartitionJobs);
 }
 
@@ -173,6 +173,13 @@ namespace {
         sTT::set_nofix45(set);
         return (true);
     }
+
+    bool
+    evSweepBooleans(const char*, bool set)
+    {
+        GEO()->setUseSweepFuncs(set);
+        return (true);
+    }
 }
 
 
@@ -529,8 +536,10 @@ namespace {
         if (set) {
             int i;
             if (str_to_int(&i, vstring) && i >= DSP_MIN_THREADS &&
-                    i <= DSP_MAX_THREADS)
+                    i <= DSP_MAX_THREADS) {
                 DSP()->SetNumThreads(i);
+                FIO()->SetNumThreads(i);
+            }
             else {
                 Log()->ErrorLogV(mh::Variables,
                     "Incorrect Threads: range %d-%d.",
@@ -538,8 +547,10 @@ namespace {
                 return (false);
             }
         }
-        else
+        else {
             DSP()->SetNumThreads(DSP_DEF_THREADS);
+            FIO()->SetNumThreads(DSP_DEF_THREADS);
+        }
         CDvdb()->registerPostFunc(postset_lx);
         return (true);
     }
@@ -682,6 +693,7 @@ cEdit::setupVariables()
     vsetup(VA_AskSaveNative,        B,  evAskSaveNative);
     vsetup("scldebug",              B,  evSafeClipping);  // for debugging
     vsetup(VA_NoFixRot45,           B,  evNoFixRot45);
+    vsetup(VA_SweepBooleans,        B,  evSweepBooleans);
 
     // Side Menu Commands
     vsetup(VA_MasterMenuLength,     S,  evMasterMenuLength);
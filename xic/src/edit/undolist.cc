@@ -1575,6 +1575,7 @@ cUndoList::CommitChanges(bool redisplay, bool nodrc)
     }
 
     if (change_made) {
+        DSP()->DbChanged();
         if (DSP()->CurMode() == Electrical) {
             for (int i = 1; i < DSP_NUMWINS; i++) {
                 if (DSP()->Window(i))
@@ -2059,6 +2060,7 @@ cUndoList::do_operation(Oper *curop, bool undo)
     CDs *cursd = CurCell();
     if (!cursd)
         return;
+    DSP()->DbChanged();
     BBox BBphys, BBelec;
     for (Oper *cur = curop; cur; cur = cur->next_in_group()) {
 
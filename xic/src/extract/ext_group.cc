@@ -55,12 +55,14 @@
 #include "tech_layer.h"
 #include "tech_via.h"
 #include "si_parsenode.h"
+#include "si_handle.h"
 #include "si_parser.h"
 #include "si_interp.h"
 #include "si_lexpr.h"
 #include "tech.h"
 #include "events.h"
 #include "errorlog.h"
+#include "miscutil/threadpool.h"
 #include <algorithm>
 
 #define TIME_DBG
@@ -185,7 +187,10 @@ cExt::group(CDs *sdesc, int depth)
         Tdbg()->start_timing("grouping");
 #endif
         SymTab tab(false, false);
-        ret = group_rec(sdesc, depth, &tab);
+        if (DSP()->NumThreads() > 0)
+            ret = group_mt(sdesc, depth, &tab);
+        else
+            ret = group_rec(sdesc, depth, &tab);
 #ifdef TIME_DBG
         Tdbg()->accum_timing("grouping");
         Tdbg()->print_accum("grouping");
@@ -317,26 +322,183 @@ cExt::group_rec(CDs *sdesc, int depth, SymTab *tab)
             ret = gd->setup_groups();
             activateGroundPlane(false);
         }
-        if (sdesc->cellname() == DSP()->CurCellName() && isShowingGroups()) {
-            cGroupDesc *gd = sdesc->groups();
-            if (gd) {
-                gd->set_group_display(true);
-                WindowDesc *wd;
-                WDgen wgen(WDgen::MAIN, WDgen::CDDB);
-                while ((wd = wgen.next()) != 0)
-                    gd->show_groups(wd, DISPLAY);
+        group_done(sdesc, ret);
+    }
+    return (ret);
+}
+
+
+namespace {
+    // List the cells under sdesc to depth, in the order that they
+    // are grouped by cExt::group_rec, subcells ahead of their
+    // parents.  The list is returned in reverse order.
+    //
+    void group_list(CDs *sdesc, int depth, SymTab *tab, tlist<CDs> **lst)
+    {
+        tab->add((unsigned long)sdesc, 0, false);
+        if (depth > 0) {
+            CDm_gen mgen(sdesc, GEN_MASTERS);
+            for (CDm *md = mgen.m_first(); md; md = mgen.m_next()) {
+                CDs *msdesc = md->celldesc();
+                if (!msdesc)
+                    continue;
+                if (SymTab::get(tab, (unsigned long)msdesc) != ST_NIL)
+                    continue;
+                group_list(msdesc, depth - 1, tab, lst);
+            }
+        }
+        *lst = new tlist<CDs>(sdesc, *lst);
+    }
+
+    // Per-cell job for the thread pool.
+    //
+    struct gr_job_t
+    {
+        gr_job_t() : gd(0), errmsg(0), ok(true) { }
+        ~gr_job_t() { delete [] errmsg; }
+
+        cGroupDesc *gd;
+        char *errmsg;
+        bool ok;
+    };
+
+    // The thread work function.  The exclusion tests are layer
+    // expression evaluations which read, but do not change, the
+    // cell and its hierarchy, so that cells can be processed
+    // concurrently.  Failure is recorded and handled in order by the
+    // caller, the other jobs are not halted.  Error messages go to a
+    // private record, and the text is saved in the job, to be passed
+    // to Errs() in the main thread.
+    //
+    int thread_proc(sTPthreadData*, void *arg)
+    {
+        gr_job_t *j = (gr_job_t*)arg;
+        ErrRec er(true);
+        ErrRec::set_thread_rec(&er);
+        j->ok = j->gd->setup_excludes();
+        ErrRec::set_thread_rec(0);
+        if (!j->ok && er.has_error())
+            j->errmsg = lstring::copy(er.get_error());
+        return (0);
+    }
+}
+
+
+// Multi-threaded version of group_rec.  The cells that need grouping
+// are listed in the order used by group_rec.  Each is cleared in
+// order, then the instance and object exclusion tests, which are
+// often the bulk of the work, are done for all cells concurrently. 
+// Finally, the grouping proper, which uses the prompt line, error
+// log and other global state, is completed serially in the original
+// order, so that the results are identical to group_rec.
+//
+XIrt
+cExt::group_mt(CDs *sdesc, int depth, SymTab *tab)
+{
+    tlist<CDs> *t0 = 0;
+    group_list(sdesc, depth, tab, &t0);
+    int ncells = tlist<CDs>::count(t0);
+
+    CDs **cells = new CDs*[ncells];
+    gr_job_t *jobs = new gr_job_t[ncells];
+    int njobs = 0;
+    for (int i = ncells - 1; i >= 0; i--) {
+        tlist<CDs> *tx = t0;
+        t0 = t0->next;
+        cells[i] = tx->elt;
+        delete tx;
+    }
+    for (int i = 0; i < ncells; i++) {
+        CDs *sd = cells[i];
+        if (sd->isConnected())
+            continue;
+        cGroupDesc *gd = sd->groups();
+        if (!gd) {
+            gd = new cGroupDesc(sd);
+            sd->setGroups(gd);
+        }
+        gd->clear_groups();
+        jobs[i].gd = gd;
+        njobs++;
+    }
+
+    if (njobs) {
+        // The layer generator table is rebuilt on first use after
+        // being dirtied, this must be done before the threads start.
+        CDextLgen lgen(CDL_CONDUCTOR);
+
+        int nth = DSP()->NumThreads();
+        if (nth > njobs - 1)
+            nth = njobs - 1;
+
+        activateGroundPlane(true);
+        if (nth > 0) {
+            cThreadPool pool(nth);
+            for (int i = 0; i < ncells; i++) {
+                if (jobs[i].gd)
+                    pool.submit(thread_proc, jobs + i);
             }
+            pool.run(0);
         }
-        if (ret == XIok) {
-            if (EX()->isVerbosePromptline())
-                PL()->ShowPromptV("Grouping complete in %s.",
-                    Tstring(sdesc->cellname()));
+        else {
+            for (int i = 0; i < ncells; i++) {
+                if (jobs[i].gd)
+                    thread_proc(0, jobs + i);
+            }
         }
-        else
-            PL()->ShowPrompt("Grouping aborted.");
+        activateGroundPlane(false);
     }
+
+    XIrt ret = XIok;
+    for (int i = 0; i < ncells; i++) {
+        CDs *sd = cells[i];
+        cGroupDesc *gd = jobs[i].gd;
+        if (gd) {
+            if (!jobs[i].ok) {
+                if (jobs[i].errmsg)
+                    Errs()->add_error("%s", jobs[i].errmsg);
+                ret = XIbad;
+            }
+            else {
+                activateGroundPlane(true);
+                ret = gd->finish_groups();
+                activateGroundPlane(false);
+            }
+        }
+        group_done(sd, ret);
+        if (ret != XIok)
+            break;
+    }
+    delete [] cells;
+    delete [] jobs;
     return (ret);
 }
+
+
+// Private function to finish up after grouping sdesc, ret is the
+// grouping return.
+//
+void
+cExt::group_done(CDs *sdesc, XIrt ret)
+{
+    if (sdesc->cellname() == DSP()->CurCellName() && isShowingGroups()) {
+        cGroupDesc *gd = sdesc->groups();
+        if (gd) {
+            gd->set_group_display(true);
+            WindowDesc *wd;
+            WDgen wgen(WDgen::MAIN, WDgen::CDDB);
+            while ((wd = wgen.next()) != 0)
+                gd->show_groups(wd, DISPLAY);
+        }
+    }
+    if (ret == XIok) {
+        if (EX()->isVerbosePromptline())
+            PL()->ShowPromptV("Grouping complete in %s.",
+                Tstring(sdesc->cellname()));
+    }
+    else
+        PL()->ShowPrompt("Grouping aborted.");
+}
 // End of cExt functions.
 
 
@@ -346,15 +508,32 @@ XIrt
 cGroupDesc::setup_groups()
 {
     clear_groups();
+    if (!setup_excludes())
+        return (XIbad);
+    return (finish_groups());
+}
+
 
+// Find the instances and objects to exclude from grouping.  This
+// evaluates layer expressions but does not otherwise change global
+// state, so that it can be called concurrently for different cells.
+//
+bool
+cGroupDesc::setup_excludes()
+{
     // Setup table of cell instances to henceforth ignore.
     find_ignored();
 
     // Process objects on layers with an exclude directive.
-    if (!process_exclude())
-        return (XIbad);
+    return (process_exclude());
+}
 
-    // do the grouping
+
+// Perform the grouping, after the exclusions have been processed.
+//
+XIrt
+cGroupDesc::finish_groups()
+{
     XIrt ret = group_objects();
     if (ret != XIok) {
         clear_groups();
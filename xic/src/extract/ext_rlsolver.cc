@@ -69,6 +69,11 @@
 #define RL_PIVREL 1e-2
 #define RL_PIVABS 1e-9
 
+// Iterative solver relative residual tolerance, and the number of
+// contacts solved together in a block.
+#define RL_CG_TOL 1e-10
+#define RL_CG_BLOCK 8
+
 // If this is set, the delta will always use this value.
 int RLsolver::rl_given_delta = 0;
 
@@ -83,6 +88,11 @@ int RLsolver::rl_maxgrid = RLS_DEF_MAX_GRID;
 // acurate results, but can be slow).
 bool RLsolver::rl_try_tile = false;
 
+// If set, solve with preconditioned conjugate gradients rather than
+// the direct sparse matrix solver.  This uses far less memory for
+// large grids.
+bool RLsolver::rl_iterative = false;
+
 
 namespace {
     unsigned long check_time;
@@ -134,6 +144,7 @@ namespace {
 RLsolver::~RLsolver()
 {
     delete rl_matrix;
+    delete rl_grid;
     delete [] rl_contacts;
     Zlist::destroy(rl_zlist);
     RLedge::destroy(rl_h_edges);
@@ -178,6 +189,10 @@ RLsolver::setup(const Zlist *zb, CDl *ld, Zgroup *zg)
     rl_nx = (rl_BB.width() + rl_delta/2)/rl_delta;
     rl_ny = (rl_BB.height() + rl_delta/2)/rl_delta;
 
+    if (rl_iterative) {
+        rl_grid = new RLgrid;
+        return (true);
+    }
     rl_matrix = new spMatrixFrame(0, 0);
     int error = rl_matrix->spError();
     if (error) {
@@ -413,7 +428,7 @@ RLsolver::setupR()
     if (fp)
         fflush(fp);
 
-    int error = rl_matrix->spError();
+    int error = rl_matrix ? rl_matrix->spError() : 0;
     if (error) {
         Errs()->add_error(rl_matrix->spErrorMessage(error));
         return (false);
@@ -575,7 +590,7 @@ RLsolver::setupL()
         }
     }
 
-    int error = rl_matrix->spError();
+    int error = rl_matrix ? rl_matrix->spError() : 0;
     if (error) {
         Errs()->add_error(rl_matrix->spErrorMessage(error));
         return (false);
@@ -595,7 +610,7 @@ RLsolver::solve_two(double *squares)
         Errs()->add_error("solve_two: solver not initialized.");
         return (false);
     }
-    int size = rl_matrix->spGetSize(1);
+    int size = rl_grid ? rl_grid->size() : rl_matrix->spGetSize(1);
     if (size <= 0) {
         Errs()->add_error("solve_two: matrix has zero size.");
         return (false);
@@ -612,12 +627,37 @@ RLsolver::solve_two(double *squares)
     for (int i = 0; i <= size; i++)
         rhs[i] = 0.0;
     rhs[1] = 1.0;  // current source
-    int error = rl_matrix->spOrderAndFactor(rhs, RL_PIVREL, RL_PIVABS, 1);
-    if (error) {
-        Errs()->add_error(rl_matrix->spErrorMessage(error));
-        return (false);
+    if (rl_grid) {
+        // Node 0 (the first contact) is ground, solve for the node
+        // voltages.
+        bool *fixed = new bool[size+1];
+        for (int i = 0; i <= size; i++)
+            fixed[i] = false;
+        fixed[0] = true;
+        double *x = new double[size+1];
+        x[0] = 0.0;
+        bool ret = rl_grid->pcg(x, rhs, 1, fixed);
+        rhs[1] = x[1];
+        delete [] x;
+        delete [] fixed;
+        if (!ret) {
+            delete [] rhs;
+            return (false);
+        }
+        if (ExtErrLog.rlsolver_log_fp()) {
+            fprintf(ExtErrLog.rlsolver_log_fp(),
+                "solve_two: %d iterations\n", rl_grid->iterations());
+        }
+    }
+    else {
+        int error = rl_matrix->spOrderAndFactor(rhs, RL_PIVREL, RL_PIVABS,
+            1);
+        if (error) {
+            Errs()->add_error(rl_matrix->spErrorMessage(error));
+            return (false);
+        }
+        rl_matrix->spSolve(rhs, rhs);
     }
-    rl_matrix->spSolve(rhs, rhs);
 
     double ohm_per_sq = 1.0;
     if (rl_state == RLresist && rl_ld) {
@@ -645,7 +685,7 @@ RLsolver::solve_multi(int *gmat_size, float **gmat)
         Errs()->add_error("solve_multi: solver not initialized.");
         return (false);
     }
-    int size = rl_matrix->spGetSize(1);
+    int size = rl_grid ? rl_grid->size() : rl_matrix->spGetSize(1);
     if (size <= 0) {
         Errs()->add_error("solve_multi: matrix has zero size.");
         return (false);
@@ -661,6 +701,9 @@ RLsolver::solve_multi(int *gmat_size, float **gmat)
             "solve_multi: size = %d delta = %d  ", size+1, rl_delta);
     }
 
+    if (rl_grid)
+        return (solve_multi_iter(size, gmat_size, gmat));
+
     int topindx = size + 1;
     for (int i = 0; i < rl_num_contacts; i++) {
         double *d = rl_matrix->spGetElement(topindx + i, i+1);
@@ -715,6 +758,77 @@ RLsolver::solve_multi(int *gmat_size, float **gmat)
 }
 
 
+// The iterative version of solve_multi.  The contacts are held at
+// fixed potentials, one contact at unit potential and the others
+// grounded, and the contact currents are obtained from the resulting
+// grid potentials.  Blocks of contacts are solved together.
+//
+bool
+RLsolver::solve_multi_iter(int size, int *gmat_size, float **gmat)
+{
+    int nc = rl_num_contacts;
+    bool *fixed = new bool[size+1];
+    for (int i = 0; i <= size; i++)
+        fixed[i] = (i < nc + rl_offset);
+
+    double ohm_per_sq = 1.0;
+    if (rl_state == RLresist && rl_ld) {
+        double rsh = cTech::GetLayerRsh(rl_ld);
+        if (rsh > 0.0)
+            ohm_per_sq = rsh;
+    }
+
+    float *g = new float[nc*nc];
+    int nblk = nc < RL_CG_BLOCK ? nc : RL_CG_BLOCK;
+    double *x = new double[(size+1)*nblk];
+    double *y = new double[(size+1)*nblk];
+    for (int j0 = 0; j0 < nc; j0 += nblk) {
+        int nr = nc - j0;
+        if (nr > nblk)
+            nr = nblk;
+        for (int i = 0; i <= size; i++) {
+            for (int k = 0; k < nr; k++)
+                x[i*nr + k] = (i == j0 + k + rl_offset) ? 1.0 : 0.0;
+        }
+
+        if (ExtErrLog.rlsolver_msgs()) {
+            fprintf(DBG_FP, ".");
+            fflush(stdout);
+        }
+        if (ExtErrLog.rlsolver_log_fp())
+            fprintf(ExtErrLog.rlsolver_log_fp(), ".");
+
+        if (!rl_grid->pcg(x, 0, nr, fixed)) {
+            delete [] x;
+            delete [] y;
+            delete [] g;
+            delete [] fixed;
+            return (false);
+        }
+
+        // The contact currents.
+        rl_grid->mult(x, y, nr);
+        for (int k = 0; k < nr; k++) {
+            float *gp = g + (j0 + k)*nc;
+            for (int i = 0; i < nc; i++)
+                gp[i] = y[(i + rl_offset)*nr + k]/ohm_per_sq;
+        }
+    }
+    delete [] x;
+    delete [] y;
+    delete [] fixed;
+
+    if (ExtErrLog.rlsolver_msgs())
+        fprintf(DBG_FP, "\n");
+    if (ExtErrLog.rlsolver_log_fp())
+        fprintf(ExtErrLog.rlsolver_log_fp(), "\n");
+
+    *gmat = g;
+    *gmat_size = nc;
+    return (true);
+}
+
+
 // Set up the edge lists.  The edge lists are used to adjust the
 // entries along Manhattan boundaries when not tiled.
 //
@@ -849,6 +963,10 @@ RLsolver::set_delta()
 void
 RLsolver::add_element(int n1, int n2, double val)
 {
+    if (rl_grid) {
+        rl_grid->add(n1, n2, val);
+        return;
+    }
     double *d;
     if (n1 > 0 && n2 > 0) {
         d = rl_matrix->spGetElement(n1, n2);
@@ -893,6 +1011,223 @@ RLsolver::l_per_sq(int d)
 // End of RLsolver functions
 
 
+// Add an element between nodes n1 and n2.
+//
+void
+RLgrid::add(int n1, int n2, double val)
+{
+    if (g_num == g_alloc) {
+        int sz = g_alloc ? 2*g_alloc : 1024;
+        int *t1 = new int[sz];
+        int *t2 = new int[sz];
+        double *tv = new double[sz];
+        if (g_num) {
+            memcpy(t1, g_n1, g_num*sizeof(int));
+            memcpy(t2, g_n2, g_num*sizeof(int));
+            memcpy(tv, g_val, g_num*sizeof(double));
+        }
+        delete [] g_n1;
+        delete [] g_n2;
+        delete [] g_val;
+        g_n1 = t1;
+        g_n2 = t2;
+        g_val = tv;
+        g_alloc = sz;
+    }
+    g_n1[g_num] = n1;
+    g_n2[g_num] = n2;
+    g_val[g_num] = val;
+    g_num++;
+    if (n1 > g_size)
+        g_size = n1;
+    if (n2 > g_size)
+        g_size = n2;
+    delete [] g_inv;
+    g_inv = 0;
+}
+
+
+// Compute the node currents y = Gx for nr vectors, which are indexed
+// as node*nr + k.
+//
+void
+RLgrid::mult(const double *x, double *y, int nr)
+{
+    int len = (g_size + 1)*nr;
+    for (int i = 0; i < len; i++)
+        y[i] = 0.0;
+    for (int i = 0; i < g_num; i++) {
+        const double *x1 = x + g_n1[i]*nr;
+        const double *x2 = x + g_n2[i]*nr;
+        double *y1 = y + g_n1[i]*nr;
+        double *y2 = y + g_n2[i]*nr;
+        double g = g_val[i];
+        for (int k = 0; k < nr; k++) {
+            double d = g*(x1[k] - x2[k]);
+            y1[k] += d;
+            y2[k] -= d;
+        }
+    }
+}
+
+
+// Solve Gx = b for nr right-hand sides, with vectors indexed as
+// node*nr + k.  On entry, x contains the potentials of the fixed
+// nodes, the others are computed.  If b is null, there are no current
+// sources.  This is the conjugate gradient method with diagonal
+// preconditioning, the nr systems are iterated together so that the
+// element list is traversed once per iteration for all of them.
+//
+bool
+RLgrid::pcg(double *x, const double *b, int nr, const bool *fixed)
+{
+    g_iters = 0;
+    int n = g_size + 1;
+    if (!g_inv) {
+        g_inv = new double[n];
+        for (int i = 0; i < n; i++)
+            g_inv[i] = 0.0;
+        for (int i = 0; i < g_num; i++) {
+            g_inv[g_n1[i]] += g_val[i];
+            g_inv[g_n2[i]] += g_val[i];
+        }
+        for (int i = 0; i < n; i++)
+            g_inv[i] = g_inv[i] > 0.0 ? 1.0/g_inv[i] : 0.0;
+    }
+
+    int len = n*nr;
+    double *r = new double[len];
+    double *z = new double[len];
+    double *p = new double[len];
+    double *q = new double[len];
+    double *rz = new double[nr];
+    double *rn0 = new double[nr];
+    double *alpha = new double[nr];
+    double *rn = new double[nr];
+    double *rzn = new double[nr];
+    bool *done = new bool[nr];
+
+    for (int i = 0; i < n; i++) {
+        if (!fixed[i]) {
+            for (int k = 0; k < nr; k++)
+                x[i*nr + k] = 0.0;
+        }
+    }
+    mult(x, q, nr);
+    for (int k = 0; k < nr; k++) {
+        rz[k] = 0.0;
+        rn0[k] = 0.0;
+    }
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < nr; k++) {
+            int ix = i*nr + k;
+            if (fixed[i])
+                r[ix] = 0.0;
+            else
+                r[ix] = (b ? b[ix] : 0.0) - q[ix];
+            z[ix] = g_inv[i]*r[ix];
+            p[ix] = z[ix];
+            rz[k] += r[ix]*z[ix];
+            rn0[k] += r[ix]*r[ix];
+        }
+    }
+    int ndone = 0;
+    for (int k = 0; k < nr; k++) {
+        done[k] = (rn0[k] == 0.0);
+        if (done[k])
+            ndone++;
+    }
+
+    bool ret = true;
+    int maxit = 2*n + 100;
+    int iter = 0;
+    for ( ; ndone < nr; iter++) {
+        if (iter == maxit) {
+            Errs()->add_error(
+                "RLgrid::pcg: no convergence after %d iterations.", iter);
+            ret = false;
+            break;
+        }
+        if ((iter & 0x3f) == 0x3f && check_for_interrupt()) {
+            Errs()->add_error("user interrupt");
+            ret = false;
+            break;
+        }
+
+        mult(p, q, nr);
+        for (int k = 0; k < nr; k++)
+            alpha[k] = 0.0;
+        for (int i = 0; i < n; i++) {
+            if (fixed[i])
+                continue;
+            for (int k = 0; k < nr; k++)
+                alpha[k] += p[i*nr + k]*q[i*nr + k];
+        }
+        for (int k = 0; k < nr; k++) {
+            if (done[k])
+                continue;
+            if (alpha[k] <= 0.0) {
+                // Breakdown, can only happen from roundoff once
+                // converged.
+                done[k] = true;
+                ndone++;
+                alpha[k] = 0.0;
+                continue;
+            }
+            alpha[k] = rz[k]/alpha[k];
+        }
+
+        for (int k = 0; k < nr; k++) {
+            rn[k] = 0.0;
+            rzn[k] = 0.0;
+        }
+        for (int i = 0; i < n; i++) {
+            if (fixed[i])
+                continue;
+            for (int k = 0; k < nr; k++) {
+                if (done[k])
+                    continue;
+                int ix = i*nr + k;
+                x[ix] += alpha[k]*p[ix];
+                r[ix] -= alpha[k]*q[ix];
+                z[ix] = g_inv[i]*r[ix];
+                rn[k] += r[ix]*r[ix];
+                rzn[k] += r[ix]*z[ix];
+            }
+        }
+        for (int k = 0; k < nr; k++) {
+            if (done[k])
+                continue;
+            if (rn[k] <= RL_CG_TOL*RL_CG_TOL*rn0[k]) {
+                done[k] = true;
+                ndone++;
+                continue;
+            }
+            double beta = rzn[k]/rz[k];
+            rz[k] = rzn[k];
+            for (int i = 0; i < n; i++) {
+                int ix = i*nr + k;
+                p[ix] = z[ix] + beta*p[ix];
+            }
+        }
+    }
+    g_iters = iter;
+
+    delete [] r;
+    delete [] z;
+    delete [] p;
+    delete [] q;
+    delete [] rz;
+    delete [] rn0;
+    delete [] alpha;
+    delete [] rn;
+    delete [] rzn;
+    delete [] done;
+    return (ret);
+}
+// End of RLgrid functions
+
+
 //-------------------------------------------------------------------------
 // MRsolver: solve for resistance on a wire net (multi-layer)
 
@@ -452,6 +452,16 @@ namespace {
         return (true);
     }
 
+    bool
+    evRLSolverIterative(const char*, bool set)
+    {
+        if (RLsolver::rl_iterative != set)
+            EX()->invalidateGroups();
+        RLsolver::rl_iterative = set;
+        CDvdb()->registerPostFunc(postset_cfg);
+        return (true);
+    }
+
     bool
     evSubcPermutationFix(const char*, bool set)
     {
@@ -792,6 +802,7 @@ cExt::setupVariables()
     vsetup(VA_RLSolverTryTile,      B,  evRLSolverTryTile);
     vsetup(VA_RLSolverGridPoints,   S,  evRLSolverGridPoints);
     vsetup(VA_RLSolverMaxPoints,    S,  evRLSolverMaxPoints);
+    vsetup(VA_RLSolverIterative,    B,  evRLSolverIterative);
     vsetup(VA_SubcPermutationFix,   B,  evSubcPermutationFix);
     vsetup(VA_VerbosePromptline,    B,  evVerbosePromptline);
     vsetup(VA_ViaCheckBtwnSubs,     B,  evViaCheckBtwnSubs);
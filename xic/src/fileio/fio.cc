@@ -105,6 +105,9 @@ cFIO::cFIO()
     fioNoStrictCellnames = false;
 
     fioChdRandomGzip = false;
+    fioChdGzipThreads = 1;
+    fioChdFlatJobs = 1;
+    fioNoInputMmap = false;
     fioAutoRename = false;
     fioNoCreateLayer = false;
     fioNoOverwritePhys = false;
@@ -144,6 +147,7 @@ cFIO::cFIO()
     fioGdsTruncateLongStrings = false;
     fioNoGdsMapOk = false;
     fioOasWriteCompressed = OAScompNone;
+    fioNumThreads = 0;
     fioOasWriteNameTab = false;
     fioOasWriteChecksum = OASchksumNone;
     fioOasWriteNoTrapezoids = false;
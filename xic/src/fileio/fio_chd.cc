@@ -74,6 +74,15 @@ cFIO::NewCHD(const char *fname, FileType ft, DisplayMode mode,
 {
     TimeDbg tdbg("chd_create");
 
+    // If we will be building a random access map and have threads
+    // available, build the map while the file is being parsed.  The
+    // map is used only if the file is gzipped.
+    //
+    zio_index_bg *zbg = 0;
+    if (fioChdRandomGzip && fioChdGzipThreads > 1 &&
+            (ft == Fgds || ft == Fcgx))
+        zbg = new zio_index_bg(fname);
+
     bool tflg = CD()->IsNoElectrical();
     if (mode == Physical)
         CD()->SetNoElectrical(true);
@@ -106,10 +115,14 @@ cFIO::NewCHD(const char *fname, FileType ft, DisplayMode mode,
     CD()->SetNoElectrical(tflg);
 
     // If set, build a random access map if the file is gzipped, for
-    // fast access to arbitrary locations.
+    // fast access to arbitrary locations.  On error, the background
+    // indexing is cancelled rather than waited for.
     //
     if (chd && fioChdRandomGzip)
-        chd->registerRandomMap();
+        chd->registerRandomMap(zbg);
+    else if (zbg)
+        zbg->cancel();
+    delete zbg;
 
     return (chd);
 }
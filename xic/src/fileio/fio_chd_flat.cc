@@ -38,6 +38,7 @@
  $Id:$
  *========================================================================*/
 
+#include "config.h"
 #include "fio.h"
 #include "fio_chd.h"
 #include "fio_chd_flat.h"
@@ -49,10 +50,23 @@
 #include "fio_chd_flat_prv.h"
 #include "cd_strmdata.h"
 #include "cd_hypertext.h"
+#include "cd_chkintr.h"
 #include "miscutil/filestat.h"
+#include "miscutil/timer.h"
 #include "miscutil/timedbg.h"
 #include <algorithm>
 
+#ifndef WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <errno.h>
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+#endif
+
 
 //-----------------------------------------------------------------------------
 // cCHD flattening functions
@@ -463,6 +477,113 @@ cCHD::readFlat(const char *cellname, const FIOcvtPrms *prms,
 }
 
 
+namespace {
+    // Record tags for the files written by flattening worker
+    // processes.
+    enum { RFR_ITEM = 'I', RFR_LAYER = 'L', RFR_BOX = 'B', RFR_POLY = 'P',
+        RFR_WIRE = 'W', RFR_END = 'E' };
+
+    // Back end used in flattening worker processes.  The geometry is
+    // saved in a file, and replayed into the real back end by the
+    // parent process.  Labels are ignored, as in the special back
+    // ends that use this.
+    //
+    struct cv_backend_rec : public cv_backend
+    {
+        cv_backend_rec(FILE *fp, bool w2p)
+            {
+                rec_fp = fp;
+                set_wire_to_poly(w2p);
+            }
+
+        bool queue_layer(const Layer *layer, bool*)
+            {
+                int len = layer->name ? strlen(layer->name) : 0;
+                putc(RFR_LAYER, rec_fp);
+                put_int(len);
+                if (len)
+                    fwrite(layer->name, 1, len, rec_fp);
+                put_int(layer->layer);
+                put_int(layer->datatype);
+                put_int(layer->index);
+                return (!ferror(rec_fp));
+            }
+
+        bool write_box(const BBox *BB)
+            {
+                putc(RFR_BOX, rec_fp);
+                put_int(BB->left);
+                put_int(BB->bottom);
+                put_int(BB->right);
+                put_int(BB->top);
+                return (!ferror(rec_fp));
+            }
+
+        bool write_poly(const Poly *po)
+            {
+                putc(RFR_POLY, rec_fp);
+                put_int(po->numpts);
+                fwrite(po->points, sizeof(Point), po->numpts, rec_fp);
+                return (!ferror(rec_fp));
+            }
+
+        bool write_wire(const Wire *w)
+            {
+                putc(RFR_WIRE, rec_fp);
+                put_int(w->attributes);
+                put_int(w->numpts);
+                fwrite(w->points, sizeof(Point), w->numpts, rec_fp);
+                return (!ferror(rec_fp));
+            }
+
+        bool write_text(const Text*) { return (true); }
+
+        // Mark the start of cell table item n.
+        void item(unsigned int n)
+            {
+                putc(RFR_ITEM, rec_fp);
+                put_int(n);
+            }
+
+        // Write the return status and error message, if any.
+        void end(OItype oiret, const char *msg)
+            {
+                int len = msg ? strlen(msg) : 0;
+                putc(RFR_END, rec_fp);
+                put_int(oiret);
+                put_int(len);
+                if (len)
+                    fwrite(msg, 1, len, rec_fp);
+            }
+
+    private:
+        void put_int(int i) { fwrite(&i, sizeof(int), 1, rec_fp); }
+
+        FILE *rec_fp;
+    };
+
+    // When set, in a worker process, cCHD::flatten will read only
+    // the cell table items assigned to this worker, which are
+    // marked in the recording back end.
+    //
+    struct rf_part_t
+    {
+        rf_part_t(cv_backend_rec *r, unsigned int p, unsigned int n)
+            {
+                rec = r;
+                part = p;
+                nparts = n;
+            }
+
+        cv_backend_rec *rec;
+        unsigned int part;
+        unsigned int nparts;
+    };
+
+    rf_part_t *rf_part;
+}
+
+
 // Read cell and its flattened hierarchy into a special database.
 //
 // Special readFlat to read objects into a flat object database.
@@ -481,7 +602,7 @@ cCHD::readFlat_odb(SymTab **tabptr, const char *cellname,
     const FIOcvtPrms *prms)
 {
     cv_backend_odb bk;
-    OItype oiret = readFlat(cellname, prms, &bk);
+    OItype oiret = readFlat_bk(cellname, prms, &bk);
     if (oiret != OIok) {
         SymTabGen gen(bk.table, true);
         SymTabEnt *h;
@@ -515,7 +636,7 @@ cCHD::readFlat_zdb(SymTab **tabptr, const char *cellname,
     const FIOcvtPrms *prms)
 {
     cv_backend_zdb bk;
-    OItype oiret = readFlat(cellname, prms, &bk);
+    OItype oiret = readFlat_bk(cellname, prms, &bk);
     if (oiret != OIok) {
         SymTabGen gen(bk.table, true);
         SymTabEnt *h;
@@ -549,7 +670,7 @@ cCHD::readFlat_zl(SymTab **tabptr, const char *cellname,
     const FIOcvtPrms *prms)
 {
     cv_backend_zl bk;
-    OItype oiret = readFlat(cellname, prms, &bk);
+    OItype oiret = readFlat_bk(cellname, prms, &bk);
     if (oiret != OIok) {
         SymTabGen gen(bk.table, true);
         SymTabEnt *h;
@@ -603,7 +724,7 @@ cCHD::readFlat_zbdb(SymTab **tabptr, const char *cellname,
     FIOcvtPrms fprms(*prms);
     fprms.set_window(&BB);
 
-    OItype oiret = readFlat(cellname, &fprms, &bk);
+    OItype oiret = readFlat_bk(cellname, &fprms, &bk);
     if (oiret != OIok) {
         SymTabGen gen(bk.output_table(), true);
         SymTabEnt *h;
@@ -629,6 +750,344 @@ cCHD::readFlat_zbdb(SymTab **tabptr, const char *cellname,
 }
 
 
+// Private function.
+// Call readFlat for the special back ends above.  If the
+// ChdFlatJobs variable is set, split the work over that many worker
+// processes.
+//
+OItype
+cCHD::readFlat_bk(const char *cellname, const FIOcvtPrms *prms,
+    cv_backend *backend)
+{
+#ifndef WIN32
+    unsigned int njobs = FIO()->ChdFlatJobs();
+    if (njobs > 1 && !rf_part) {
+        OItype oiret;
+        if (readFlat_fork(cellname, prms, backend, njobs, &oiret))
+            return (oiret);
+    }
+#endif
+    return (readFlat(cellname, prms, backend));
+}
+
+
+#ifndef WIN32
+
+namespace {
+    // Reader for a worker file, in the parent.
+    //
+    struct rf_replay
+    {
+        rf_replay()
+            {
+                fp = 0;
+                lname = 0;
+                status = OIerror;
+                msg = 0;
+            }
+
+        ~rf_replay()
+            {
+                if (fp)
+                    fclose(fp);
+                delete [] lname;
+                delete [] msg;
+            }
+
+        bool get_int(int *i)
+            {
+                return (fread(i, sizeof(int), 1, fp) == 1);
+            }
+
+        char *get_str()
+            {
+                int len;
+                if (!get_int(&len) || len < 0)
+                    return (0);
+                char *str = new char[len + 1];
+                if (fread(str, 1, len, fp) != (size_t)len) {
+                    delete [] str;
+                    return (0);
+                }
+                str[len] = 0;
+                return (str);
+            }
+
+        Point *get_points(int *num)
+            {
+                if (!get_int(num) || *num <= 0)
+                    return (0);
+                Point *pts = new Point[*num];
+                if (fread(pts, sizeof(Point), *num, fp) != (size_t)*num) {
+                    delete [] pts;
+                    return (0);
+                }
+                return (pts);
+            }
+
+        bool get_layer()
+            {
+                delete [] lname;
+                lname = get_str();
+                layer.name = lname;
+                return (lname && get_int(&layer.layer) &&
+                    get_int(&layer.datatype) && get_int(&layer.index));
+            }
+
+        bool get_end()
+            {
+                int st;
+                if (!get_int(&st))
+                    return (false);
+                status = (OItype)st;
+                msg = get_str();
+                return (msg != 0);
+            }
+
+        FILE *fp;           // worker file
+        char *lname;        // current layer name
+        Layer layer;        // current layer
+        OItype status;      // worker return
+        char *msg;          // worker error message
+    };
+}
+
+
+// Private function.
+// Flatten using njobs worker processes.  Each worker builds the same
+// cell table as cCHD::flatten, but reads only every njobs'th item,
+// recording the output geometry in a temporary file.  The parent
+// then replays the files into backend in table order, so that the
+// back end sees exactly the same sequence of calls as when
+// flattening serially.  If worker processes can't be created, false
+// is returned and the caller should call readFlat.  Otherwise, the
+// return value is passed in retp.
+//
+// Processes are used rather than threads since the back ends have no
+// locking, the readers add to the unlocked cell name string table,
+// and the error log and the static transform registers are shared.
+//
+bool
+cCHD::readFlat_fork(const char *cellname, const FIOcvtPrms *prms,
+    cv_backend *backend, unsigned int njobs, OItype *retp)
+{
+    // The layers are created in the parent, as in readFlat.
+    if (!createLayers()) {
+        *retp = OIerror;
+        return (true);
+    }
+
+    char *base = filestat::make_temp("rfl");
+    char *fn = new char[strlen(base) + 16];
+
+    int *pids = new int[njobs];
+    for (unsigned int w = 0; w < njobs; w++) {
+        int pid = fork();
+        if (pid == 0) {
+            // In worker, suppress messages and interrupt checking,
+            // which may use graphics, and detach from the terminal.
+            CD()->SetIgnoreIntr(true);
+            CD()->RegisterIfInfoMessage(0);
+            FIO()->RegisterIfInfoMessage(0);
+            FIO()->RegisterIfSetWorking(0);
+            FIO()->SetFlatReadFeedback(false);
+
+            // The parent terminates workers with SIGTERM on
+            // interrupt.  The inherited handler would run the
+            // application exit cleanup, just die instead.
+            signal(SIGTERM, SIG_DFL);
+
+            int fd = ::open("/dev/null", O_RDWR);
+            if (fd >= 0) {
+                dup2(fd, 0);
+                dup2(fd, 1);
+                dup2(fd, 2);
+                if (fd > 2)
+                    close(fd);
+            }
+
+            sprintf(fn, "%s.%u", base, w);
+            FILE *fp = fopen(fn, "wb");
+            if (fp) {
+                cv_backend_rec rec(fp, backend->wire_to_poly());
+                rf_part_t rp(&rec, w, njobs);
+                rf_part = &rp;
+                Errs()->init_error();
+                OItype oiret = readFlat(cellname, prms, &rec);
+                rec.end(oiret, oiret == OIok ? 0 : Errs()->get_error());
+                fclose(fp);
+            }
+            _exit(0);  // gtk error if exit() called due to atexit()
+        }
+        if (pid < 0) {
+            // Can't fork, kill any workers started and let the caller
+            // run sequentially.
+            for (unsigned int i = 0; i < w; i++) {
+                kill(pids[i], SIGKILL);
+                waitpid(pids[i], 0, 0);
+            }
+            for (unsigned int i = 0; i < njobs; i++) {
+                sprintf(fn, "%s.%u", base, i);
+                unlink(fn);
+            }
+            delete [] pids;
+            delete [] fn;
+            delete [] base;
+            return (false);
+        }
+        pids[w] = pid;
+    }
+
+    // Wait for the workers.  The SIGCHLD handler may reap a worker
+    // before we do, so ECHILD also indicates completion.
+    OItype oiret = OIok;
+    unsigned int nleft = njobs;
+    for (;;) {
+        for (unsigned int w = 0; w < njobs; w++) {
+            if (pids[w] <= 0)
+                continue;
+            int status;
+            int p = waitpid(pids[w], &status, WNOHANG);
+            if (p == pids[w] || (p < 0 && errno == ECHILD)) {
+                pids[w] = 0;
+                nleft--;
+            }
+        }
+        if (!nleft)
+            break;
+        if (oiret == OIok &&
+                checkInterrupt("Interrupt received, abort translation? ")) {
+            for (unsigned int w = 0; w < njobs; w++) {
+                if (pids[w] > 0)
+                    kill(pids[w], SIGTERM);
+            }
+            oiret = OIaborted;
+        }
+        cTimer::milli_sleep(50);
+    }
+    delete [] pids;
+
+    // Replay the worker output, in cell table order.
+    rf_replay *reps = new rf_replay[njobs];
+    for (unsigned int w = 0; w < njobs; w++) {
+        sprintf(fn, "%s.%u", base, w);
+        if (oiret == OIok) {
+            reps[w].fp = fopen(fn, "rb");
+            if (!reps[w].fp) {
+                Errs()->add_error(
+                    "cCHD::readFlat: can't open worker file %s.", fn);
+                oiret = OIerror;
+            }
+        }
+    }
+    if (oiret == OIok) {
+        TimeDbg tdbg("read_flat_replay");
+        unsigned int last = njobs;
+        for (unsigned int n = 0; oiret == OIok; n++) {
+            if (checkInterrupt("Interrupt received, abort translation? ")) {
+                oiret = OIaborted;
+                break;
+            }
+            unsigned int w = n % njobs;
+            rf_replay *r = reps + w;
+            int c = getc(r->fp);
+            if (c == RFR_END) {
+                // The worker has no more items, so all items have
+                // been processed.
+                ungetc(c, r->fp);
+                break;
+            }
+            int m;
+            if (c != RFR_ITEM || !r->get_int(&m) || (unsigned int)m != n) {
+                Errs()->add_error("cCHD::readFlat: bad worker file data.");
+                oiret = OIerror;
+                break;
+            }
+            if (w != last && r->lname) {
+                // Restore the current layer from this worker.
+                if (!backend->queue_layer(&r->layer)) {
+                    oiret = backend->aborted() ? OIaborted : OIerror;
+                    break;
+                }
+            }
+            last = w;
+
+            bool ok = true;
+            while (ok) {
+                c = getc(r->fp);
+                if (c == RFR_ITEM || c == RFR_END) {
+                    ungetc(c, r->fp);
+                    break;
+                }
+                if (c == RFR_LAYER) {
+                    ok = r->get_layer() && backend->queue_layer(&r->layer);
+                }
+                else if (c == RFR_BOX) {
+                    BBox BB;
+                    ok = r->get_int(&BB.left) && r->get_int(&BB.bottom) &&
+                        r->get_int(&BB.right) && r->get_int(&BB.top) &&
+                        backend->write_box(&BB);
+                }
+                else if (c == RFR_POLY) {
+                    Poly po;
+                    po.points = r->get_points(&po.numpts);
+                    ok = po.points && backend->write_poly(&po);
+                    delete [] po.points;
+                }
+                else if (c == RFR_WIRE) {
+                    Wire wire;
+                    int atr;
+                    ok = r->get_int(&atr);
+                    if (ok) {
+                        wire.attributes = atr;
+                        wire.points = r->get_points(&wire.numpts);
+                        ok = wire.points && backend->write_wire(&wire);
+                        delete [] wire.points;
+                    }
+                }
+                else
+                    ok = false;
+            }
+            if (!ok) {
+                if (backend->aborted())
+                    oiret = OIaborted;
+                else {
+                    Errs()->add_error(
+                        "cCHD::readFlat: bad worker file data.");
+                    oiret = OIerror;
+                }
+            }
+        }
+
+        // Each worker file should now be at the end record.
+        for (unsigned int w = 0; w < njobs && oiret == OIok; w++) {
+            rf_replay *r = reps + w;
+            if (getc(r->fp) != RFR_END || !r->get_end()) {
+                Errs()->add_error("cCHD::readFlat: no result from worker.");
+                oiret = OIerror;
+            }
+            else if (r->status != OIok) {
+                if (r->status == OIerror && *r->msg)
+                    Errs()->add_error("%s", r->msg);
+                oiret = r->status;
+            }
+        }
+    }
+    delete [] reps;
+
+    for (unsigned int w = 0; w < njobs; w++) {
+        sprintf(fn, "%s.%u", base, w);
+        unlink(fn);
+    }
+    delete [] fn;
+    delete [] base;
+    *retp = oiret;
+    return (true);
+}
+
+#endif
+
+
 namespace {
     // A struct to handle user feedback while flattening.
     //
@@ -841,7 +1300,16 @@ cCHD::flatten(symref_t *p, cv_in *in, int maxdepth, const FIOcvtPrms *prms)
         unsigned char *tstream;
         flat_read_fb frfb(fc.ctab->num_cells(0));
         cvtab_item_t *item;
+        unsigned int itemcnt = 0;
         while ((item = ctgen.next()) != 0) {
+            if (rf_part) {
+                // In a worker process, read only our share of the
+                // items (see readFlat_fork).
+                unsigned int n = itemcnt++;
+                if (n % rf_part->nparts != rf_part->part)
+                    continue;
+                rf_part->rec->item(n);
+            }
             tchd = fc.ctab->get_chd(item->get_chd_tkt());
             tp = item->symref();
             tstream = fc.ctab->get_tstream(item);
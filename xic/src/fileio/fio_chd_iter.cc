@@ -51,6 +51,17 @@
 #include "si_interp.h"
 #include "si_lexpr.h"
 #include "si_spt.h"
+#include "miscutil/filestat.h"
+#include "miscutil/timer.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <sys/wait.h>
+#endif
 
 
 //
@@ -173,6 +184,35 @@ done:
 XIrt
 cv_chd_iter::run2(cCHD *chd1, const char *cname1, cCHD *chd2,
     const char *cname2,  const BBox *AOI)
+{
+    XIrt ret = setup2(chd1, cname1, chd2, cname2, AOI);
+    if (ret != XIok)
+        return (ret);
+
+    int nvals = num_regions();
+    FIO()->ifSetWorking(true);
+    for (int n = 0; n < nvals; n++) {
+        ret = region2(n);
+        if (ret != XIok || ci_endit)
+            break;
+        FIO()->ifInfoMessage(IFMSG_INFO, "Completed %d of %d.", n + 1,
+            nvals);
+
+        if (checkInterrupt()) {
+            ret = XIintr;
+            break;
+        }
+    }
+    FIO()->ifSetWorking(false);
+    return (ret);
+}
+
+
+// Check the arguments and set up the coarse grid for run2.
+//
+XIrt
+cv_chd_iter::setup2(cCHD *chd1, const char *cname1, cCHD *chd2,
+    const char *cname2,  const BBox *AOI)
 {
     if (!chd1) {
         Errs()->add_error("run2: null CHD-1 pointer given.");
@@ -196,6 +236,7 @@ cv_chd_iter::run2(cCHD *chd1, const char *cname1, cCHD *chd2,
     }
 
     ci_chd1 = chd1;
+    ci_cname1 = cname1;
     ci_symref1 = ci_chd1->findSymref(cname1, Physical, true);
     if (!ci_symref1) {
         Errs()->add_error("run2: unresolved top-1 cell.");
@@ -204,6 +245,7 @@ cv_chd_iter::run2(cCHD *chd1, const char *cname1, cCHD *chd2,
     ci_chd1->setBoundaries(ci_symref1);
 
     ci_chd2 = chd2;
+    ci_cname2 = cname2;
     ci_symref2 = ci_chd2->findSymref(cname2, Physical, true);
     if (!ci_symref2) {
         Errs()->add_error("run2: unresolved top-2 cell.");
@@ -218,102 +260,94 @@ cv_chd_iter::run2(cCHD *chd1, const char *cname1, cCHD *chd2,
         ci_aoiBB.add(ci_symref2->get_bb());
     }
 
-    int nxc = ci_aoiBB.width()/ci_coarse_grid +
+    ci_nxc = ci_aoiBB.width()/ci_coarse_grid +
        (ci_aoiBB.width()%ci_coarse_grid != 0);
-    int nyc = ci_aoiBB.height()/ci_coarse_grid +
+    ci_nyc = ci_aoiBB.height()/ci_coarse_grid +
        (ci_aoiBB.height()%ci_coarse_grid != 0);
-    int nvals = nxc*nyc;
-
-    XIrt ret = XIok;
-    FIO()->ifSetWorking(true);
-    for (int ic = 0; ic < nyc; ic++) {
-        for (int jc = 0; jc < nxc; jc++) {
-            int cur_cx = ci_aoiBB.left + jc*ci_coarse_grid;
-            int cur_cy = ci_aoiBB.bottom + ic*ci_coarse_grid;
-            BBox cBB(cur_cx, cur_cy,
-                cur_cx + ci_coarse_grid, cur_cy + ci_coarse_grid);
-            if (cBB.right > ci_aoiBB.right)
-                cBB.right = ci_aoiBB.right;
-            if (cBB.top > ci_aoiBB.top)
-                cBB.top = ci_aoiBB.top;
+    return (XIok);
+}
 
-            FIOcvtPrms prms;
-            prms.set_allow_layer_mapping(true);
-            prms.set_use_window(true);
-            prms.set_window(&cBB);
 
-            SymTab *tab = 0;  // must pass 0 to create new tab
-            OItype oiret = ci_chd1->readFlat_zbdb(&tab, cname1, &prms,
-                ci_fine_grid, ci_fine_grid, ci_bloat_val, ci_bloat_val);
-            if (oiret != OIok) {
-                if (oiret == OIaborted)
-                    ret = XIintr;
-                else {
-                    Errs()->add_error("run: geometry-1 read failed.");
-                    ret = XIbad;
-                }
-                goto done;
-            }
-            ci_db1 = new cSDB(DBNAME1, tab, sdbZbdb);
-            if (!CDsdb()->saveDB(ci_db1)) {
-                Errs()->add_error("run2: failed to save ZBDB-1.");
-                delete ci_db1;
-                ci_db1 = 0;
-                ret = XIbad;
-                goto done;
-            }
+// Read the two databases for coarse grid cell n, which are numbered
+// by rows from the lower left, and call iterFunc.
+//
+XIrt
+cv_chd_iter::region2(int n)
+{
+    BBox cBB;
+    region_bb(n, &cBB);
+
+    FIOcvtPrms prms;
+    prms.set_allow_layer_mapping(true);
+    prms.set_use_window(true);
+    prms.set_window(&cBB);
+
+    SymTab *tab = 0;  // must pass 0 to create new tab
+    OItype oiret = ci_chd1->readFlat_zbdb(&tab, ci_cname1, &prms,
+        ci_fine_grid, ci_fine_grid, ci_bloat_val, ci_bloat_val);
+    if (oiret != OIok) {
+        if (oiret == OIaborted)
+            return (XIintr);
+        Errs()->add_error("run: geometry-1 read failed.");
+        return (XIbad);
+    }
+    ci_db1 = new cSDB(DBNAME1, tab, sdbZbdb);
+    if (!CDsdb()->saveDB(ci_db1)) {
+        Errs()->add_error("run2: failed to save ZBDB-1.");
+        delete ci_db1;
+        ci_db1 = 0;
+        return (XIbad);
+    }
 
-            tab = 0;  // must pass 0 to create new tab
-            oiret = ci_chd2->readFlat_zbdb(&tab, cname2, &prms,
-                ci_fine_grid, ci_fine_grid, ci_bloat_val, ci_bloat_val);
-            if (oiret != OIok) {
-                if (oiret == OIaborted)
-                    ret = XIintr;
-                else {
-                    Errs()->add_error("run: geometry-2 read failed.");
-                    ret = XIbad;
-                }
-                CDsdb()->destroyDB(DBNAME1);
-                ci_db1 = 0;
-                goto done;
-            }
-            ci_db2 = new cSDB(DBNAME2, tab, sdbZbdb);
-            if (!CDsdb()->saveDB(ci_db2)) {
-                Errs()->add_error("run2: failed to save ZBDB-2.");
-                delete ci_db2;
-                ci_db2 = 0;
-                CDsdb()->destroyDB(DBNAME1);
-                ci_db1 = 0;
-                ret = XIbad;
-                goto done;
-            }
+    tab = 0;  // must pass 0 to create new tab
+    oiret = ci_chd2->readFlat_zbdb(&tab, ci_cname2, &prms,
+        ci_fine_grid, ci_fine_grid, ci_bloat_val, ci_bloat_val);
+    if (oiret != OIok) {
+        CDsdb()->destroyDB(DBNAME1);
+        ci_db1 = 0;
+        if (oiret == OIaborted)
+            return (XIintr);
+        Errs()->add_error("run: geometry-2 read failed.");
+        return (XIbad);
+    }
+    ci_db2 = new cSDB(DBNAME2, tab, sdbZbdb);
+    if (!CDsdb()->saveDB(ci_db2)) {
+        Errs()->add_error("run2: failed to save ZBDB-2.");
+        delete ci_db2;
+        ci_db2 = 0;
+        CDsdb()->destroyDB(DBNAME1);
+        ci_db1 = 0;
+        return (XIbad);
+    }
 
-            ret = iterFunc(&cBB);
-            CDsdb()->destroyDB(DBNAME1);
-            CDsdb()->destroyDB(DBNAME2);
-            ci_db1 = 0;
-            ci_db2 = 0;
+    XIrt ret = iterFunc(&cBB);
+    CDsdb()->destroyDB(DBNAME1);
+    CDsdb()->destroyDB(DBNAME2);
+    ci_db1 = 0;
+    ci_db2 = 0;
 
-            if (ret != XIok) {
-                Errs()->add_error("run2: iteration %s at %d,%d.",
-                    ret == XIintr ? "aborted" : "failed", cur_cx, cur_cy);
-                goto done;
-            }
-            if (ci_endit)
-                goto done;
-            FIO()->ifInfoMessage(IFMSG_INFO, "Completed %d of %d.",
-                ic*nxc + jc + 1, nvals);
-
-            if (checkInterrupt()) {
-                ret = XIintr;
-                goto done;
-            }
-        }
+    if (ret != XIok) {
+        Errs()->add_error("run2: iteration %s at %d,%d.",
+            ret == XIintr ? "aborted" : "failed", cBB.left, cBB.bottom);
     }
-done:
-    FIO()->ifSetWorking(false);
     return (ret);
 }
+
+
+// Set BB to the area of coarse grid cell n, clipped to the AOI.
+//
+void
+cv_chd_iter::region_bb(int n, BBox *BB)
+{
+    int cur_cx = ci_aoiBB.left + (n % ci_nxc)*ci_coarse_grid;
+    int cur_cy = ci_aoiBB.bottom + (n / ci_nxc)*ci_coarse_grid;
+    *BB = BBox(cur_cx, cur_cy, cur_cx + ci_coarse_grid,
+        cur_cy + ci_coarse_grid);
+    if (BB->right > ci_aoiBB.right)
+        BB->right = ci_aoiBB.right;
+    if (BB->top > ci_aoiBB.top)
+        BB->top = ci_aoiBB.top;
+}
 // End of cv_chd_iter functions.
 
 
@@ -748,6 +782,10 @@ cCHD::createDensityMaps(const char *cellname, const BBox *AOI,
 // This iterates over two assumed similar hierarchies, comparing the
 // geometry and recording differences.
 
+// Control lines in the region files written by worker processes.
+#define CMP_CTL "#@cmpdiff"
+#define CMP_END "#@cmpend"
+
 namespace {
     struct sCmpIter : public cv_chd_iter
     {
@@ -758,16 +796,19 @@ namespace {
                 ci_ltab = 0;
                 ci_ldiffs = 0;
                 ci_last_ld = 0;
+                ci_last_lname = 0;
                 ci_diffmax = dm;
                 ci_diffcnt = 0;
                 ci_last_state = 0;
                 ci_lskip = false;
+                ci_ctl = false;
             }
 
         ~sCmpIter()
             {
                 delete ci_ltab;
                 delete getDiffs();
+                delete [] ci_last_lname;
             }
 
         unsigned int diffCount() { return (ci_diffcnt); }
@@ -775,18 +816,25 @@ namespace {
 
         void setupLayers(const char*, bool);
         Sdiff *getDiffs();
+#ifndef WIN32
+        XIrt run2_fork(cCHD*, const char*, cCHD*, const char*,
+            const BBox*, unsigned int);
+#endif
 
     private:
         XIrt iterFunc(const BBox*);
+        XIrt merge_region(FILE*, int, bool*);
 
         FILE *ci_fp;
         SymTab *ci_ltab;
         SymTab *ci_ldiffs;
         CDl *ci_last_ld;
+        char *ci_last_lname;
         unsigned int ci_diffmax;
         unsigned int ci_diffcnt;
         short ci_last_state;
         bool ci_lskip;
+        bool ci_ctl;
     };
 
 
@@ -942,6 +990,7 @@ namespace {
                     }
                     bool local = (ld0 == 0);
                     int state = 0;
+                    unsigned int cnt0 = ci_diffcnt;
 
                     ret = Zlist::zl_andnot2(&z1, &z2);
                     if (ret == XIintr) {
@@ -1005,7 +1054,15 @@ namespace {
                     ci_diffcnt += diffcnt;
 
                     if (ci_fp) {
-                        if (ld0) {
+                        if (ld0 && ci_ctl) {
+                            // In a worker, the header is always printed
+                            // and the parent removes repeats.
+                            fprintf(ci_fp, "%s %d %u %s\n", CMP_CTL, state,
+                                ci_diffcnt - cnt0, ld->name());
+                            ld0->print(ci_fp, false);
+                            delete ld0;
+                        }
+                        else if (ld0) {
                             // Some stuff to avoid repeating header string.
                             bool nohdr =
                                 (ci_last_ld == ld && ci_last_state == state);
@@ -1025,7 +1082,7 @@ namespace {
                             delete ld0;
                     }
                     if (ci_diffmax > 0 && ci_diffcnt >= ci_diffmax) {
-                        if (ci_fp) {
+                        if (ci_fp && !ci_ctl) {
                             fprintf(ci_fp,
                                 "*** Max difference count %d reached.\n",
                                 ci_diffmax);
@@ -1040,6 +1097,272 @@ namespace {
         stringlist::destroy(layers);
         return (ret);
     }
+
+
+#ifndef WIN32
+
+    // Compare using njobs worker processes.  Worker w compares coarse
+    // grid regions w, w + njobs, ..., writing the output for each
+    // region to a temporary file, which is terminated with a status
+    // line.  Each layer difference is preceded by a control line
+    // giving the state, difference count and layer name.  The workers
+    // inherit the CHDs, and each has its own readers and databases.
+    //
+    // When the workers are done, the region files are added to the
+    // output in region order, removing repeated headers and applying
+    // the difference limit, so that the output is the same as from a
+    // sequential run.  If workers can't be created, the regions are
+    // compared sequentially.
+    //
+    // Processes are used rather than threads since the readers add to
+    // the unlocked cell name string table, the zbdb databases are
+    // built with the shared layer table, and the error log and the
+    // static transform registers have no locking.
+    //
+    XIrt
+    sCmpIter::run2_fork(cCHD *chd1, const char *cname1, cCHD *chd2,
+        const char *cname2, const BBox *AOI, unsigned int njobs)
+    {
+        XIrt ret = setup2(chd1, cname1, chd2, cname2, AOI);
+        if (ret != XIok)
+            return (ret);
+        int nvals = num_regions();
+        if (nvals < 2 || !ci_fp)
+            return (run2(chd1, cname1, chd2, cname2, AOI));
+        if ((int)njobs > nvals)
+            njobs = nvals;
+
+        char *base = filestat::make_temp("cmp");
+        char *fn = new char[strlen(base) + 16];
+        fflush(ci_fp);
+
+        int *pids = new int[njobs];
+        for (unsigned int w = 0; w < njobs; w++) {
+            int pid = fork();
+            if (pid == 0) {
+                // In worker, suppress messages and interrupt checking,
+                // which may use graphics, and detach from the terminal.
+                // The flat reads are not split further.
+                CD()->SetIgnoreIntr(true);
+                CD()->RegisterIfInfoMessage(0);
+                FIO()->RegisterIfInfoMessage(0);
+                FIO()->RegisterIfSetWorking(0);
+                FIO()->SetFlatReadFeedback(false);
+                FIO()->SetChdFlatJobs(1);
+
+                // The parent terminates workers with SIGTERM on
+                // interrupt.  The inherited handler would run the
+                // application exit cleanup, just die instead.
+                signal(SIGTERM, SIG_DFL);
+
+                int fd = ::open("/dev/null", O_RDWR);
+                if (fd >= 0) {
+                    dup2(fd, 0);
+                    dup2(fd, 1);
+                    dup2(fd, 2);
+                    if (fd > 2)
+                        close(fd);
+                }
+
+                ci_ctl = true;
+                for (int n = w; n < nvals; n += njobs) {
+                    sprintf(fn, "%s.%d", base, n);
+                    FILE *rfp = fopen(fn, "w");
+                    if (!rfp)
+                        break;
+                    ci_fp = rfp;
+                    XIrt rret = region2(n);
+                    fprintf(rfp, "%s %d\n", CMP_END, rret);
+                    fclose(rfp);
+
+                    // The difference count of the merged output is
+                    // at least as large as ours, so once the limit
+                    // is reached later regions won't be used.
+                    if (rret != XIok || ci_endit)
+                        break;
+                }
+                _exit(0);  // gtk error if exit() called due to atexit()
+            }
+            if (pid < 0) {
+                // Can't fork, kill any workers started and run
+                // sequentially.
+                for (unsigned int i = 0; i < w; i++) {
+                    kill(pids[i], SIGKILL);
+                    waitpid(pids[i], 0, 0);
+                }
+                for (int n = 0; n < nvals; n++) {
+                    sprintf(fn, "%s.%d", base, n);
+                    unlink(fn);
+                }
+                delete [] pids;
+                delete [] fn;
+                delete [] base;
+                return (run2(chd1, cname1, chd2, cname2, AOI));
+            }
+            pids[w] = pid;
+        }
+
+        FIO()->ifSetWorking(true);
+        FIO()->ifInfoMessage(IFMSG_INFO,
+            "Comparing %d regions using %d processes.", nvals, njobs);
+
+        // Wait for the workers.  The SIGCHLD handler may reap a worker
+        // before we do, so ECHILD also indicates completion.
+        unsigned int nleft = njobs;
+        for (;;) {
+            for (unsigned int w = 0; w < njobs; w++) {
+                if (pids[w] <= 0)
+                    continue;
+                int status;
+                int p = waitpid(pids[w], &status, WNOHANG);
+                if (p == pids[w] || (p < 0 && errno == ECHILD)) {
+                    pids[w] = 0;
+                    nleft--;
+                }
+            }
+            if (!nleft)
+                break;
+            if (ret == XIok && checkInterrupt()) {
+                for (unsigned int w = 0; w < njobs; w++) {
+                    if (pids[w] > 0)
+                        kill(pids[w], SIGTERM);
+                }
+                ret = XIintr;
+            }
+            cTimer::milli_sleep(50);
+        }
+        delete [] pids;
+
+        // Merge the region files, in order.  After an interrupt, the
+        // completed regions up to the first incomplete one are kept.
+        bool done = false;
+        for (int n = 0; n < nvals; n++) {
+            sprintf(fn, "%s.%d", base, n);
+            if (!done) {
+                FILE *rfp = fopen(fn, "r");
+                if (!rfp && ret == XIintr) {
+                    unlink(fn);
+                    done = true;
+                    continue;
+                }
+                XIrt rret = merge_region(rfp, n, &done);
+                if (rfp)
+                    fclose(rfp);
+                if (rret != XIok) {
+                    if (ret == XIok)
+                        ret = rret;
+                    done = true;
+                }
+            }
+            unlink(fn);
+        }
+        FIO()->ifSetWorking(false);
+        delete [] fn;
+        delete [] base;
+        return (ret);
+    }
+
+
+    // Copy the worker output for region n from fp to the output file,
+    // handling the control lines.  On return, done is set if the
+    // difference limit was reached, and there is nothing more to do.
+    //
+    XIrt
+    sCmpIter::merge_region(FILE *fp, int n, bool *done)
+    {
+        BBox cBB;
+        region_bb(n, &cBB);
+        if (!fp) {
+            Errs()->add_error("run2: no result from region at %d,%d.",
+                cBB.left, cBB.bottom);
+            return (XIbad);
+        }
+
+        char buf[256];
+        sLstr lstr;
+        int state = 0;
+        unsigned int cnt = 0;
+        bool inchunk = false;
+        bool skiphdr = false;
+        int rret = XIbad;
+        bool gotend = false;
+        for (;;) {
+            // Read a full line into lstr.
+            lstr.free();
+            bool eof = true;
+            while (fgets(buf, 256, fp) != 0) {
+                eof = false;
+                lstr.add(buf);
+                if (strchr(buf, '\n'))
+                    break;
+            }
+            const char *line = lstr.string();
+            bool isctl = !eof && lstring::prefix(CMP_CTL, line);
+            bool isend = !eof && lstring::prefix(CMP_END, line);
+
+            if (inchunk && (eof || isctl || isend)) {
+                // End of a layer difference, apply the limit as in
+                // iterFunc.
+                ci_diffcnt += cnt;
+                inchunk = false;
+                if (ci_diffmax > 0 && ci_diffcnt >= ci_diffmax) {
+                    fprintf(ci_fp, "*** Max difference count %d reached.\n",
+                        ci_diffmax);
+                    ci_endit = true;
+                    *done = true;
+                    return (XIok);
+                }
+            }
+            if (eof)
+                break;
+            if (isend) {
+                if (sscanf(line + strlen(CMP_END), "%d", &rret) == 1)
+                    gotend = true;
+                break;
+            }
+            if (isctl) {
+                const char *s = line + strlen(CMP_CTL);
+                char *tok1 = lstring::gettok(&s);
+                char *tok2 = lstring::gettok(&s);
+                char *tok3 = lstring::gettok(&s);
+                bool ok = tok3 && sscanf(tok1, "%d", &state) == 1 &&
+                    sscanf(tok2, "%u", &cnt) == 1;
+                delete [] tok1;
+                delete [] tok2;
+                if (!ok) {
+                    delete [] tok3;
+                    break;
+                }
+
+                // Some stuff to avoid repeating header string.
+                skiphdr = (ci_last_lname && !strcmp(ci_last_lname, tok3) &&
+                    ci_last_state == state);
+                delete [] ci_last_lname;
+                ci_last_lname = tok3;
+                ci_last_state = (state & 0x3);
+                inchunk = true;
+                continue;
+            }
+            if (skiphdr) {
+                skiphdr = false;
+                continue;
+            }
+            fputs(line, ci_fp);
+        }
+
+        if (!gotend) {
+            Errs()->add_error("run2: no result from region at %d,%d.",
+                cBB.left, cBB.bottom);
+            return (XIbad);
+        }
+        if (rret != XIok) {
+            Errs()->add_error("run2: iteration %s at %d,%d.",
+                rret == XIintr ? "aborted" : "failed", cBB.left, cBB.bottom);
+        }
+        return ((XIrt)rret);
+    }
+
+#endif
     // End of sCmpIter functions.
 }
 
@@ -1072,7 +1395,16 @@ cCHD::compareCHDs_fp(
 
     sCmpIter iter(fp, maxerrs, cgm, fg);
     iter.setupLayers(layer_list, skip);
-    XIrt ret = iter.run2(chd1, cname1, chd2, cname2, AOI);
+    XIrt ret;
+#ifndef WIN32
+    // The coarse grid regions are compared in parallel if the
+    // ChdFlatJobs variable is set.
+    unsigned int njobs = FIO()->ChdFlatJobs();
+    if (njobs > 1)
+        ret = iter.run2_fork(chd1, cname1, chd2, cname2, AOI, njobs);
+    else
+#endif
+    ret = iter.run2(chd1, cname1, chd2, cname2, AOI);
     if (ret != XIbad) {
         if (errcnt)
             *errcnt = iter.diffCount();
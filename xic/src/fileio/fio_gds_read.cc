@@ -1507,16 +1507,20 @@ gds_in::get_record()
     if (in_rectype == II_XY) {
         in_numpts = in_recsize >> 3;
 
-        char *p;
-        if (sizeof(int) == 4)
-            p = (char*)in_points;
-        else
-            p = (char*)in_cbuf;
+        // If the file is memory mapped, decode the coordinates in
+        // place.
+        char *p = in_bswap ? 0 : (char*)in_fp->z_mapped(in_recsize);
+        if (!p) {
+            if (sizeof(int) == 4)
+                p = (char*)in_points;
+            else
+                p = (char*)in_cbuf;
 
-        if (!gds_read(p, in_recsize)) {
-            if (in_rectype == II_EOF)
-                return (true);
-            return (false);
+            if (!gds_read(p, in_recsize)) {
+                if (in_rectype == II_EOF)
+                    return (true);
+                return (false);
+            }
         }
         if (in_action == cvOpenModePrint) {
             for (int i = 0; i < in_numpts; i++) {
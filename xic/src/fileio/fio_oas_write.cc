@@ -50,6 +50,7 @@
 #include "cd_chkintr.h"
 #include "geo_zlist.h"
 #include "miscutil/filestat.h"
+#include "miscutil/threadpool.h"
 #include <ctype.h>
 
 
@@ -183,6 +184,86 @@ cFIO::ZlistToFile(Zlist *zlist, const char *lname, const char *fname)
 #define MODAL_ASSIGN(x, y) out_modal->x = y, out_modal->x##_set = true
 
 
+// Queue for compressing cell CBLOCKs in parallel.  When the Threads
+// variable is set to a nonzero value, output bytes are saved in
+// an ordered list of blocks instead of being written.  A block is
+// either raw file data, or the uncompressed body of a cell.  When
+// the queue is flushed, the cell bodies are compressed by a thread
+// pool, and all blocks are written to the file in order.  Each body
+// is deflated in one pass with the same parameters as zio_stream, so
+// the file is identical to the one written serially.
+//
+struct oas_zqueue
+{
+    struct blk_t
+    {
+        unsigned char *data;    // raw bytes or uncompressed body
+        unsigned char *zdata;   // compressed body
+        size_t      size;       // bytes in data
+        size_t      alloc;      // allocated size of data
+        size_t      zsize;      // bytes in zdata
+        bool        body;       // cell body, compress
+    };
+
+    oas_zqueue(unsigned int);
+    ~oas_zqueue();
+
+    // Add a byte to the raw block at the end of the queue.
+    void put_raw(int c)
+        {
+            if (!zq_nblks || zq_blks[zq_nblks-1].body)
+                new_blk(false);
+            put(c);
+        }
+
+    // Add a byte to the cell body being collected.
+    void put(int c)
+        {
+            blk_t *b = zq_blks + zq_nblks - 1;
+            if (b->size == b->alloc)
+                grow(b);
+            b->data[b->size++] = c;
+        }
+
+    void begin_body()               { new_blk(true); }
+    size_t body_size()              { return (zq_blks[zq_nblks-1].size); }
+    bool pending()                  { return (zq_nblks > 0); }
+
+    // The queue should be flushed when this returns true.
+    bool full()
+        {
+            return (zq_nbodies >= ZQ_MAXBODIES*zq_nthreads ||
+                zq_bytes >= ZQ_MAXBYTES);
+        }
+
+    void end_body(bool);
+    unsigned char *take_body(size_t*);
+    bool flush(FILE*);
+
+    // Bodies larger than this are compressed in the calling thread
+    // through a temp file, as when not using the queue.
+    static const size_t ZQ_MAXBODY = 0x10000000;
+
+private:
+    void new_blk(bool);
+    void grow(blk_t*);
+    void clear();
+
+    static int compress_proc(sTPthreadData*, void*);
+
+    cThreadPool *zq_pool;       // helper threads
+    blk_t       *zq_blks;       // queued blocks, in file order
+    size_t      zq_bytes;       // uncompressed body bytes queued
+    unsigned int zq_nblks;      // number of blocks queued
+    unsigned int zq_size;       // size of zq_blks
+    unsigned int zq_nbodies;    // number of bodies queued
+    unsigned int zq_nthreads;   // number of threads, including main
+
+    static const unsigned int ZQ_MAXBODIES = 16;
+    static const size_t ZQ_MAXBYTES = 0x4000000;
+};
+
+
 // If the arg is true, we are writing to an in-core database rather
 // than a file.  The in_filename is the database tag name.  In this
 // mode, the OasWrite... variables are ignored - maximum compression
@@ -230,6 +311,7 @@ oas_out::oas_out(cCGD *cgd)
     out_modal = &out_default_modal;
     out_zfile = 0;
     out_cache = 0;
+    out_zqueue = 0;
     out_compr_buf = 0;
     if (use_cgd)
         out_rep_args = lstring::copy("");
@@ -272,6 +354,10 @@ oas_out::oas_out(cCGD *cgd)
         out_validation_type = 0;
     else
         out_validation_type = FIO()->OasWriteChecksum();
+
+    if (!use_cgd && out_use_compression != OAScompNone &&
+            FIO()->NumThreads() > 0)
+        out_zqueue = new oas_zqueue(FIO()->NumThreads() + 1);
 }
 
 
@@ -300,6 +386,7 @@ oas_out::~oas_out()
     }
     delete out_lmux;
     delete out_cache;
+    delete out_zqueue;
     delete out_cellname_tab;
     delete out_textstring_tab;
     delete out_propname_tab;
@@ -436,6 +523,8 @@ oas_out::set_destination(FILE *fp, void **new_cx, void **old_cx)
         else
             memcpy(out_modal, *new_cx, sizeof(oas_modal));
     }
+    if (!flush_zqueue())
+        return (false);
     out_fp = fp;
     return (true);
 }
@@ -498,6 +587,8 @@ oas_out::write_library(int, double, double, tm*, tm*, const char*)
 
     // Save START position for checksum computation.  This is of course
     // 0, except for the electrical records extension.
+    if (!flush_zqueue())
+        return (false);
     out_start_offset = large_ftell(out_fp);
 
     // write file magic header
@@ -1745,6 +1836,14 @@ oas_out::write_endlib(const char*)
     }
     if (out_cgd)
         return (true);
+
+    // Flush the compression queue, the tables and END record are
+    // written directly.
+    if (!flush_zqueue())
+        return (false);
+    delete out_zqueue;
+    out_zqueue = 0;
+
     if (!write_tables())
         return (false);
 
@@ -2241,6 +2340,55 @@ oas_out::write_char(int c)
                 return (false);
             }
         }
+        else if (out_zqueue) {
+            if (out_zqueue->body_size() == oas_zqueue::ZQ_MAXBODY) {
+                // Huge cell, write the queue and compress this one
+                // through the temp file.
+
+                size_t nbytes;
+                unsigned char *buf = out_zqueue->take_body(&nbytes);
+                if (!flush_zqueue()) {
+                    delete [] buf;
+                    return (false);
+                }
+                if (!out_tmp_fp) {
+                    out_tmp_fname = filestat::make_temp("cd");
+                    out_tmp_fp = large_fopen(out_tmp_fname, "wb+");
+                    if (!out_tmp_fp) {
+                        Errs()->add_error(
+                            "write_char: open failed for temp file.");
+                        delete [] buf;
+                        return (false);
+                    }
+                }
+                else
+                    rewind(out_tmp_fp);
+                out_zfile = zio_stream::zio_open(out_tmp_fp, "wb");
+                if (!out_zfile) {
+                    Errs()->add_error("write_char: open failed.");
+                    delete [] buf;
+                    return (false);
+                }
+                out_comp_start = out_byte_count;
+                out_byte_count += nbytes;
+                for (size_t i = 0; i < nbytes; i++) {
+                    if (out_zfile->zio_putc(buf[i]) == EOF) {
+                        Errs()->add_error("zio_putc failed.");
+                        Errs()->add_error("write error, file system full?");
+                        delete [] buf;
+                        return (false);
+                    }
+                }
+                delete [] buf;
+                if (out_zfile->zio_putc(c) == EOF) {
+                    Errs()->add_error("zio_putc failed.");
+                    Errs()->add_error("write error, file system full?");
+                    return (false);
+                }
+            }
+            else
+                out_zqueue->put(c);
+        }
         else {
             int nbytes = out_byte_count - out_comp_start;
             if (nbytes == CGD_COMPR_BUFSIZE ||
@@ -2288,6 +2436,8 @@ oas_out::write_char(int c)
             }
         }
     }
+    else if (out_zqueue && out_zqueue->pending())
+        out_zqueue->put_raw(c);
     else {
         if (putc(c, out_fp) == EOF) {
             Errs()->sys_error("write");
@@ -3519,6 +3669,14 @@ oas_out::begin_compression(const char *cellname)
             "begin_compression: internal, already compressing!");
         return (false);
     }
+    if (out_zqueue) {
+        // The file position is not known while the queue holds data,
+        // the byte count is exact only after a flush.
+        out_comp_start = out_byte_count;
+        out_zqueue->begin_body();
+        out_compressing = true;
+        return (true);
+    }
     out_comp_start = large_ftell(out_fp);
     out_byte_count = out_comp_start;  // should already be equal
     out_compressing = true;
@@ -3547,6 +3705,18 @@ oas_out::end_compression()
     if (!out_compressing)
         return (true);
     out_compressing = false;
+    if (out_zqueue && !out_zfile) {
+        // Small bodies are written without a CBLOCK, as below.
+        size_t nbytes = out_zqueue->body_size();
+        bool cmp = (nbytes > CGD_COMPR_BUFSIZE ||
+            (nbytes > 0 && out_use_compression == OAScompForce));
+        out_zqueue->end_body(cmp);
+        if (cmp)
+            out_byte_count = out_comp_start;
+        if (out_zqueue->full())
+            return (flush_zqueue());
+        return (true);
+    }
     if (!out_zfile) {
         // Compressor was never created, so don't use a CBLOCK.
         int nbytes = out_byte_count - out_comp_start;
@@ -3589,6 +3759,220 @@ oas_out::end_compression()
 }
 
 
+// Compress and write out the queued blocks, if any.  This must be
+// called before the file position is used.
+//
+bool
+oas_out::flush_zqueue()
+{
+    if (!out_zqueue || !out_zqueue->pending())
+        return (true);
+    if (!out_zqueue->flush(out_fp))
+        return (false);
+    out_byte_count = large_ftell(out_fp);
+    return (true);
+}
+
+
+//------------------------------------------------------------------------
+// oas_zqueue functions
+//------------------------------------------------------------------------
+
+oas_zqueue::oas_zqueue(unsigned int nth)
+{
+    zq_pool = 0;
+    zq_blks = 0;
+    zq_bytes = 0;
+    zq_nblks = 0;
+    zq_size = 0;
+    zq_nbodies = 0;
+    zq_nthreads = nth;
+}
+
+
+oas_zqueue::~oas_zqueue()
+{
+    clear();
+    delete [] zq_blks;
+    delete zq_pool;
+}
+
+
+// Finish the cell body being collected.  If cmp is false, the body
+// is too small to compress and is written as raw data.
+//
+void
+oas_zqueue::end_body(bool cmp)
+{
+    blk_t *b = zq_blks + zq_nblks - 1;
+    if (cmp) {
+        zq_nbodies++;
+        zq_bytes += b->size;
+    }
+    else
+        b->body = false;
+}
+
+
+// Remove the cell body being collected from the queue and return its
+// data, which should be freed by the caller.
+//
+unsigned char *
+oas_zqueue::take_body(size_t *psz)
+{
+    zq_nblks--;
+    blk_t *b = zq_blks + zq_nblks;
+    unsigned char *d = b->data;
+    *psz = b->size;
+    b->data = 0;
+    return (d);
+}
+
+
+// Compress the queued bodies, and write all blocks to fp in order.
+// Each compressed body is preceded by the CBLOCK record header.
+//
+bool
+oas_zqueue::flush(FILE *fp)
+{
+    if (zq_nbodies > 1 && zq_nthreads > 1) {
+        if (!zq_pool)
+            zq_pool = new cThreadPool(zq_nthreads - 1);
+        zq_pool->clear();
+        for (unsigned int i = 0; i < zq_nblks; i++) {
+            if (zq_blks[i].body)
+                zq_pool->submit(compress_proc, zq_blks + i);
+        }
+        if (zq_pool->run(0)) {
+            Errs()->add_error("flush: compression failed.");
+            clear();
+            return (false);
+        }
+    }
+    else {
+        for (unsigned int i = 0; i < zq_nblks; i++) {
+            if (zq_blks[i].body && compress_proc(0, zq_blks + i)) {
+                Errs()->add_error("flush: compression failed.");
+                clear();
+                return (false);
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < zq_nblks; i++) {
+        blk_t *b = zq_blks + i;
+        if (b->body) {
+            // CBLOCK: '34' '0' u-count c-count bytes
+            unsigned char hbuf[24];
+            int n = 0;
+            hbuf[n++] = 34;
+            hbuf[n++] = 0;
+            uint64_t v = b->size;
+            while (v > 0x7f) {
+                hbuf[n++] = (v & 0x7f) | 0x80;
+                v >>= 7;
+            }
+            hbuf[n++] = v;
+            v = b->zsize;
+            while (v > 0x7f) {
+                hbuf[n++] = (v & 0x7f) | 0x80;
+                v >>= 7;
+            }
+            hbuf[n++] = v;
+            if (fwrite(hbuf, 1, n, fp) != (size_t)n ||
+                    fwrite(b->zdata, 1, b->zsize, fp) != b->zsize) {
+                Errs()->sys_error("write");
+                Errs()->add_error("write error, file system full?");
+                clear();
+                return (false);
+            }
+        }
+        else if (b->size && fwrite(b->data, 1, b->size, fp) != b->size) {
+            Errs()->sys_error("write");
+            Errs()->add_error("write error, file system full?");
+            clear();
+            return (false);
+        }
+    }
+    clear();
+    return (true);
+}
+
+
+void
+oas_zqueue::new_blk(bool body)
+{
+    if (zq_nblks == zq_size) {
+        unsigned int nsz = zq_size ? 2*zq_size : 32;
+        blk_t *tmp = new blk_t[nsz];
+        if (zq_nblks)
+            memcpy(tmp, zq_blks, zq_nblks*sizeof(blk_t));
+        delete [] zq_blks;
+        zq_blks = tmp;
+        zq_size = nsz;
+    }
+    blk_t *b = zq_blks + zq_nblks++;
+    b->data = 0;
+    b->zdata = 0;
+    b->size = 0;
+    b->alloc = 0;
+    b->zsize = 0;
+    b->body = body;
+}
+
+
+void
+oas_zqueue::grow(blk_t *b)
+{
+    size_t nsz = b->alloc ? 2*b->alloc : 256;
+    unsigned char *tmp = new unsigned char[nsz];
+    if (b->size)
+        memcpy(tmp, b->data, b->size);
+    delete [] b->data;
+    b->data = tmp;
+    b->alloc = nsz;
+}
+
+
+void
+oas_zqueue::clear()
+{
+    for (unsigned int i = 0; i < zq_nblks; i++) {
+        delete [] zq_blks[i].data;
+        delete [] zq_blks[i].zdata;
+    }
+    zq_nblks = 0;
+    zq_nbodies = 0;
+    zq_bytes = 0;
+}
+
+
+// Thread job, deflate a cell body in one pass.  The parameters match
+// those used by zio_stream for writing.
+//
+int
+oas_zqueue::compress_proc(sTPthreadData*, void *arg)
+{
+    blk_t *b = (blk_t*)arg;
+    z_stream strm;
+    memset(&strm, 0, sizeof(z_stream));
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+            -MAX_WBITS, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+        return (-1);
+    uLong bsz = deflateBound(&strm, b->size);
+    b->zdata = new unsigned char[bsz];
+    strm.next_in = b->data;
+    strm.avail_in = b->size;
+    strm.next_out = b->zdata;
+    strm.avail_out = bsz;
+    int err = deflate(&strm, Z_FINISH);
+    b->zsize = bsz - strm.avail_out;
+    deflateEnd(&strm);
+    return (err == Z_STREAM_END ? 0 : -1);
+}
+// End of oas_zqueue functions.
+
+
 // If using repetitions, the objects are dumped here.
 //
 bool
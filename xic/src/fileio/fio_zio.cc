@@ -43,9 +43,13 @@
 #include "fio.h"
 #include "fio_zio.h"
 #include "fio_chd.h"
+#include "miscutil/threadpool.h"
 #include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
 
 #ifdef WIN32
 // The regular fseeko/ftello are not available, but the 64-bit versions
@@ -58,6 +62,10 @@
 #ifdef ZLIB_VERNUM
 #if (ZLIB_VERNUM >= 0x1230)
 #define Z_HAS_RANDOM_MAP
+#ifndef WIN32
+// Parallel inflation of map spans, uses pread.
+#define Z_HAS_AHEAD
+#endif
 #endif
 #endif
 
@@ -101,6 +109,14 @@ sFilePtr::newFilePtr(const char *path, const char *mode)
             return (0);
         if (getc(fp) != GZMAGIC_0 || getc(fp) != GZMAGIC_1) {
             rewind(fp);
+            if (!FIO()->IsNoInputMmap()) {
+                // Uncompressed, read through a memory map if possible.
+                zio_mmap *map = zio_mmap::open_map(fp);
+                if (map) {
+                    fclose(fp);
+                    return (new sFilePtr(map));
+                }
+            }
             return (new sFilePtr(0, fp));
         }
         rewind(fp);
@@ -166,6 +182,19 @@ sFilePtr::z_seek(int64_t offset, int whence)
 {
     if (file)
         return (file->zio_seek(offset, whence));
+    else if (map) {
+        if (whence == SEEK_CUR)
+            offset += map_pos;
+        else if (whence == SEEK_END)
+            offset += map->size();
+        else if (whence != SEEK_SET)
+            return (-1);
+        if (offset < 0)
+            return (-1);
+        map_pos = offset;
+        map_eof = false;
+        return (0);
+    }
     else if (fp)
         return (fseeko(fp, offset, whence));
     return (-1);
@@ -177,6 +206,8 @@ sFilePtr::z_tell()
 {
     if (file)
         return (file->zio_tell());
+    else if (map)
+        return (map_pos);
     else if (fp)
         return (ftello(fp));
     return (-1);
@@ -184,6 +215,92 @@ sFilePtr::z_tell()
 // End of sFilePtr functions
 
 
+//-----------------------------------------------------------------------------
+// zio_mmap functions
+
+zio_mmap *zio_mmap::zm_list = 0;
+
+// Static function.
+// Return a read-only map of the regular file open in fp, or null if
+// the file can't be mapped.  If the file is already mapped, the
+// existing map is returned, with the reference count incremented. 
+// The fp is not used after return and can be closed.
+//
+zio_mmap *
+zio_mmap::open_map(FILE *fp)
+{
+#ifdef WIN32
+    (void)fp;
+    return (0);
+#else
+    if (!fp)
+        return (0);
+    int fd = fileno(fp);
+    struct stat st;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+        return (0);
+
+    for (zio_mmap *m = zm_list; m; m = m->zm_next) {
+        if (m->zm_dev == st.st_dev && m->zm_ino == st.st_ino &&
+                m->zm_size == (int64_t)st.st_size &&
+                m->zm_mtime == st.st_mtime) {
+            m->zm_refcnt++;
+            return (m);
+        }
+    }
+
+    // Skip if the file size exceeds the address space.
+    size_t sz = st.st_size;
+    if ((int64_t)sz != (int64_t)st.st_size)
+        return (0);
+    void *addr = mmap(0, sz, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+        return (0);
+
+    zio_mmap *m = new zio_mmap;
+    m->zm_base = (const unsigned char*)addr;
+    m->zm_size = st.st_size;
+    m->zm_dev = st.st_dev;
+    m->zm_ino = st.st_ino;
+    m->zm_mtime = st.st_mtime;
+    m->zm_refcnt = 1;
+    m->zm_next = zm_list;
+    zm_list = m;
+    return (m);
+#endif
+}
+
+
+// Static function.
+// Release a reference to the map, unmapping when there are no more
+// users.
+//
+void
+zio_mmap::close_map(zio_mmap *map)
+{
+    if (!map)
+        return;
+    if (--map->zm_refcnt > 0)
+        return;
+    zio_mmap *mp = 0;
+    for (zio_mmap *m = zm_list; m; m = m->zm_next) {
+        if (m == map) {
+            if (mp)
+                mp->zm_next = m->zm_next;
+            else
+                zm_list = m->zm_next;
+            break;
+        }
+        mp = m;
+    }
+#ifndef WIN32
+    munmap((void*)map->zm_base, map->zm_size);
+#endif
+    delete map;
+}
+// End of zio_mmap functions
+
+
 // This should be used instead of fopen when support for large files
 // is needed.
 //
@@ -362,15 +479,29 @@ namespace {
             return (false);
         return (true);
     }
+
+
+    // Return the number of uncompressed bytes between access points
+    // for new maps.
+    //
+    unsigned int map_span()
+    {
+        unsigned int span = SPAN;
+        if (FIO()->ChdRandomGzip() > 1)
+            span *= FIO()->ChdRandomGzip();
+        return (span);
+    }
 }
 
 
 // Build and store a zio_index map for the file associated with the
 // CHD, if it is gzipped.  Return true if a map was created, already
-// exists, or is not needed, false on error.
+// exists, or is not needed, false on error.  If bg is given, it is
+// used to obtain the map, which was built while the CHD was being
+// created.
 //
 bool
-cCHD::registerRandomMap()
+cCHD::registerRandomMap(zio_index_bg *bg)
 {
 #ifdef Z_HAS_RANDOM_MAP
     if (c_filetype != Fgds && c_filetype != Fcgx) {
@@ -427,18 +558,18 @@ printf("assigned an existing map using file end crc\n");
             return (true);
         }
     }
-    rewind(fp);
-
-    zio_index *zi = new zio_index;
-    unsigned int span = SPAN;
-    if (FIO()->ChdRandomGzip() > 1)
-        span *= FIO()->ChdRandomGzip();
-    int ret = zi->build_index(fp, span);
-    fclose(fp);
-    if (ret < 0) {
-        delete zi;
-        return (false);
+    zio_index *zi = bg ? bg->finish() : 0;
+    if (!zi) {
+        rewind(fp);
+        zi = new zio_index;
+        int ret = zi->build_index(fp, map_span());
+        if (ret < 0) {
+            fclose(fp);
+            delete zi;
+            return (false);
+        }
     }
+    fclose(fp);
     if (!zi->crc()) {
         // Something's foobar, shouldn't happen.
         delete zi;
@@ -525,6 +656,215 @@ cCHD::getRandomMap(unsigned int crc)
 // End of cCHD functions
 
 
+//-----------------------------------------------------------------------------
+// zio_index_bg -- Build a zio_index in a separate thread.
+
+// The thread is started in the constructor.  The span is obtained
+// here, in the main thread.
+//
+zio_index_bg::zio_index_bg(const char *fname)
+{
+    bg_fname = lstring::copy(fname);
+    bg_index = 0;
+    bg_span = map_span();
+    bg_cancel = false;
+    bg_running = (pthread_create(&bg_thread, 0, bg_proc, this) == 0);
+}
+
+
+// If the index was not claimed with finish, e.g., the parse failed,
+// the thread is stopped rather than waited for.
+//
+zio_index_bg::~zio_index_bg()
+{
+    cancel();
+    delete finish();
+    delete [] bg_fname;
+}
+
+
+// Wait for the thread to finish, and return the index, which now
+// belongs to the caller.  The return is null if the file is not
+// gzipped, or on error.
+//
+zio_index *
+zio_index_bg::finish()
+{
+    if (bg_running) {
+        pthread_join(bg_thread, 0);
+        bg_running = false;
+    }
+    zio_index *zi = bg_index;
+    bg_index = 0;
+    return (zi);
+}
+
+
+// Static function.
+// The thread procedure, this must not use anything that is not
+// thread-safe.
+//
+void *
+zio_index_bg::bg_proc(void *arg)
+{
+    zio_index_bg *bg = (zio_index_bg*)arg;
+    FILE *fp = large_fopen(bg->bg_fname, "rb");
+    if (!fp)
+        return (0);
+    if (is_gzipped(fp)) {
+        rewind(fp);
+        zio_index *zi = new zio_index;
+        if (zi->build_index(fp, bg->bg_span, &bg->bg_cancel) > 0 &&
+                zi->crc())
+            bg->bg_index = zi;
+        else
+            delete zi;
+    }
+    fclose(fp);
+    return (0);
+}
+// End of zio_index_bg functions.
+
+
+//-----------------------------------------------------------------------------
+// zio_ahead -- Parallel inflation for gzipped files with a map.
+//
+// The access points of a zio_index divide the uncompressed data into
+// spans, and each span can be inflated independently since the point
+// saves the preceding window.  When reading a file that has a map,
+// the spans are inflated in batches by a thread pool, one span per
+// thread.  A batch is inflated when the reader reaches the end of
+// the previous one, and the reader waits for it, there is no
+// overlap of inflation and reading.  After a seek, reading is serial
+// from the nearest access point as before, so that short CHD
+// accesses don't inflate data that is never used.  The parallel
+// inflation is engaged once the reader has read through a full span.
+//
+// Each thread also computes the CRC of its span, these are combined
+// as the spans are read, and the gzip trailer is checked at the end
+// of the last span as in the serial case.
+
+#ifdef Z_HAS_AHEAD
+namespace {
+    // Work for one span.
+    //
+    struct za_job_t
+    {
+        const zio_index::point_t *pt;   // access point of span
+        unsigned char *buf;             // inflated data
+        unsigned int size;              // size of buf
+        unsigned int len;               // bytes inflated
+        uint64_t want;                  // span length, 0 to end
+        unsigned int crc;               // CRC of span
+        int fd;                         // compressed file
+        unsigned char trailer[8];       // gzip trailer, last span only
+    };
+
+
+    int za_proc(sTPthreadData*, void *arg)
+    {
+        za_job_t *j = (za_job_t*)arg;
+        int ret = zio_index::inflate_span(j->fd, j->pt, &j->buf, &j->size,
+            j->want, j->want ? 0 : j->trailer);
+        if (ret < 0)
+            return (1);
+        j->len = ret;
+        j->crc = crc32(crc32(0, 0, 0), j->buf, j->len);
+        return (0);
+    }
+}
+
+
+struct zio_ahead
+{
+    zio_ahead(int, unsigned int);
+    ~zio_ahead();
+
+    int load(zio_index*, int);
+
+    // Revert to serial reading, engage again when the reader reaches
+    // offset e.
+    void reset(uint64_t e)
+        {
+            za_engage = e;
+            za_nspans = 0;
+            za_cur = 0;
+            za_active = false;
+        }
+
+    cThreadPool *za_pool;       // helper threads
+    za_job_t    *za_jobs;       // one job/buffer per thread
+    uint64_t    za_engage;      // offset where parallel reading starts
+    int         za_nthreads;    // number of threads, including main
+    int         za_nspans;      // number of spans loaded
+    int         za_cur;         // loaded span being read
+    bool        za_active;      // reading from loaded spans
+};
+
+
+zio_ahead::zio_ahead(int fd, unsigned int nth)
+{
+    za_pool = new cThreadPool(nth - 1);
+    za_nthreads = za_pool->num_threads() + 1;
+    za_jobs = new za_job_t[za_nthreads];
+    memset(za_jobs, 0, za_nthreads*sizeof(za_job_t));
+    for (int i = 0; i < za_nthreads; i++)
+        za_jobs[i].fd = fd;
+    za_engage = 0;
+    za_nspans = 0;
+    za_cur = 0;
+    za_active = false;
+}
+
+
+zio_ahead::~zio_ahead()
+{
+    delete za_pool;
+    for (int i = 0; i < za_nthreads; i++)
+        delete [] za_jobs[i].buf;
+    delete [] za_jobs;
+}
+
+
+// Inflate a span for each thread (or fewer at the end of the map)
+// starting with the span at access point first.  Return 0 on
+// success, -1 on error.
+//
+int
+zio_ahead::load(zio_index *zi, int first)
+{
+    za_nspans = 0;
+    za_cur = 0;
+    int n = zi->num_points() - first;
+    if (n > za_nthreads)
+        n = za_nthreads;
+    if (n <= 0)
+        return (-1);
+    for (int i = 0; i < n; i++) {
+        za_job_t *j = za_jobs + i;
+        j->pt = zi->point(first + i);
+        const zio_index::point_t *nx = zi->point(first + i + 1);
+        j->want = nx ? nx->out - j->pt->out : 0;
+        j->len = 0;
+    }
+    if (n == 1) {
+        if (za_proc(0, za_jobs))
+            return (-1);
+    }
+    else {
+        za_pool->clear();
+        for (int i = 0; i < n; i++)
+            za_pool->submit(za_proc, za_jobs + i);
+        if (za_pool->run(0))
+            return (-1);
+    }
+    za_nspans = n;
+    return (0);
+}
+#endif
+// End of zio_ahead functions.
+
+
 //------------------------------------------------------------------------
 // zio_stream methods
 //
@@ -579,6 +919,7 @@ zio_stream::zio_stream(FILE *fp)
     z_strm.avail_in = z_strm.avail_out = 0;
     z_fp = fp;
     z_zfp = 0;
+    z_ahead = 0;
     z_ptr = 0;
     z_startpos = fp ? large_ftell(fp) : 0;
     z_total_in = 0;
@@ -611,6 +952,9 @@ zio_stream::~zio_stream()
     }
     delete [] z_inbuf;
     delete [] z_outbuf;
+#ifdef Z_HAS_AHEAD
+    delete z_ahead;
+#endif
 }
 
 
@@ -919,6 +1263,14 @@ zio_stream::zio_read(void *buf, unsigned int len)
     char *cp = (char*)buf;
     while (len) {
         if (z_avail == 0) {
+            if (use_ahead()) {
+                z_avail = ahead_fill();
+                if (z_avail < 0)
+                    return (-1);
+                if (z_avail == 0)
+                    break;
+                continue;
+            }
             if (!z_outbuf)
                 z_outbuf = new Byte[Z_OUTSIZE];
             z_avail = read_core(z_outbuf, Z_OUTSIZE);
@@ -977,6 +1329,13 @@ zio_stream::zio_rewind()
 
     z_err = Z_OK;
     z_eof = 0;
+#ifdef Z_HAS_AHEAD
+    if (z_ahead) {
+        zio_index *zi = cCHD::getRandomMap(z_file_crc);
+        zio_index::point_t *nx = zi ? zi->point(2) : 0;
+        z_ahead->reset(nx ? nx->out : (uint64_t)-1);
+    }
+#endif
     z_strm.avail_in = 0;
     z_strm.next_in = z_inbuf;
     z_crc = crc32(0, 0, 0);
@@ -1049,8 +1408,11 @@ printf("seeking %lld %d, file crc %x\n", offset, whence, z_file_crc);
 if (zi)
 printf("found map\n");
 #endif
-        if (zi)
+        if (zi) {
+            if (ahead_seek(offset, zi))
+                return (0);
             return (seek_to(offset, zi));
+        }
     }
 
     // Offset of start of current in-memory block.
@@ -1214,6 +1576,167 @@ printf("SEEKING from table %lld %lld %d\n", offset, here->out, here->bits);
 }
 
 
+// Create the parallel inflation state if possible.  This requires a
+// gzipped file with a random access map, and more than one thread
+// from the ChdGzipThreads variable.
+//
+bool
+zio_stream::new_ahead()
+{
+#ifdef Z_HAS_AHEAD
+    if (z_mode != 'r' || !z_fp || !z_file_crc)
+        return (false);
+    unsigned int nth = FIO()->ChdGzipThreads();
+    if (nth < 2)
+        return (false);
+    zio_index *zi = cCHD::getRandomMap(z_file_crc);
+    if (!zi)
+        return (false);
+    z_ahead = new zio_ahead(fileno(z_fp), nth);
+
+    // Start reading serially, as if we had just seeked to 0.
+    zio_index::point_t *nx = zi->point(2);
+    z_ahead->reset(nx ? nx->out : (uint64_t)-1);
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+
+// Called when the output buffer is empty, return true if the next
+// data should come from ahead_fill.
+//
+bool
+zio_stream::use_ahead()
+{
+#ifdef Z_HAS_AHEAD
+    if (!z_ahead && !new_ahead())
+        return (false);
+    if (!z_ahead->za_active) {
+        if ((uint64_t)z_total_out < z_ahead->za_engage)
+            return (false);
+        z_ahead->za_active = true;
+    }
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+
+// Set up the output buffer pointers to read the next span, loading
+// more spans if necessary.  Return the number of bytes available,
+// 0 at the end of the stream, or -1 on error.
+//
+int
+zio_stream::ahead_fill()
+{
+#ifdef Z_HAS_AHEAD
+    zio_index *zi = cCHD::getRandomMap(z_file_crc);
+    if (!zi) {
+        z_err = Z_ERRNO;
+        return (-1);
+    }
+    zio_ahead *za = z_ahead;
+    uint64_t posn = z_total_out;
+    if (za->za_cur + 1 < za->za_nspans)
+        za->za_cur++;
+    else {
+        // The get_point method may return the previous point when
+        // posn is exactly at an access point.
+        int first = zi->point_num(zi->get_point(posn));
+        zio_index::point_t *nx = zi->point(first + 1);
+        if (nx && nx->out <= posn)
+            first++;
+        if (za->load(zi, first) < 0) {
+            z_err = Z_DATA_ERROR;
+            return (-1);
+        }
+    }
+    za_job_t *j = za->za_jobs + za->za_cur;
+    if (posn < j->pt->out || posn >= j->pt->out + j->len) {
+        z_eof = true;
+        return (0);
+    }
+    if (z_had_header && !z_no_checksum) {
+        // Keep the running CRC, the reader may have entered the span
+        // partway through if reading serially before.
+        unsigned int off = posn - j->pt->out;
+        if (off == 0)
+            z_crc = crc32_combine(z_crc, j->crc, j->len);
+        else
+            z_crc = crc32(z_crc, j->buf + off, j->len - off);
+        if (!j->want) {
+            // Last span, check the trailer CRC and size.
+            const unsigned char *t = j->trailer;
+            unsigned int crc = t[0] | (t[1] << 8) | (t[2] << 16) |
+                ((unsigned int)t[3] << 24);
+            unsigned int isize = t[4] | (t[5] << 8) | (t[6] << 16) |
+                ((unsigned int)t[7] << 24);
+            if (crc != z_crc ||
+                    isize != ((j->pt->out + j->len) & 0xffffffff)) {
+                z_err = Z_DATA_ERROR;
+                return (-1);
+            }
+        }
+    }
+    z_ptr = (char*)j->buf + (posn - j->pt->out);
+    z_total_out = j->pt->out + j->len;
+    return (z_total_out - posn);
+#else
+    return (-1);
+#endif
+}
+
+
+// Called before seek_to.  If reading from loaded spans and offset is
+// in one of these, set the pointers and return true.  Otherwise
+// revert to serial reading and return false, the caller will then
+// call seek_to.  Parallel reading will resume if the reader gets
+// through the span that follows the one containing offset.
+//
+bool
+zio_stream::ahead_seek(int64_t offset, zio_index *zi)
+{
+#ifdef Z_HAS_AHEAD
+    if (!z_ahead && !new_ahead())
+        return (false);
+    zio_ahead *za = z_ahead;
+    bool was_active = za->za_active;
+    if (was_active) {
+        for (int i = 0; i < za->za_nspans; i++) {
+            za_job_t *j = za->za_jobs + i;
+            if ((uint64_t)offset >= j->pt->out &&
+                    (uint64_t)offset < j->pt->out + j->len) {
+                za->za_cur = i;
+                z_ptr = (char*)j->buf + (offset - j->pt->out);
+                z_total_out = j->pt->out + j->len;
+                z_avail = z_total_out - offset;
+                return (true);
+            }
+        }
+    }
+    // The serial inflation state is stale, start over so seek_to
+    // can work from a known state.
+    if (was_active)
+        zio_rewind();
+
+    int n = zi->point_num(zi->get_point(offset));
+    zio_index::point_t *nx = zi->point(n + 1);
+    if (nx && nx->out <= (uint64_t)offset)
+        n++;
+    nx = zi->point(n + 2);
+    za->reset(nx ? nx->out : (uint64_t)-1);
+    return (false);
+#else
+    (void)offset;
+    (void)zi;
+    return (false);
+#endif
+}
+
+
 int
 zio_stream::read_core(void *buf, unsigned int len)
 {
@@ -1505,10 +2028,12 @@ zio_stream::check_gz_header()
 // gzip stream in the file is ignored.  This returns the number of
 // access points on success (>= 1), Z_MEM_ERROR for out of memory,
 // Z_DATA_ERROR for an error in the input file, or Z_ERRNO for a file
-// read error.
+// read error.  If cancel is given, it is polled, and Z_ERRNO is
+// returned if it becomes true.
 //
 int
-zio_index::build_index(FILE *in, unsigned int span)
+zio_index::build_index(FILE *in, unsigned int span,
+    const volatile bool *cancel)
 {
 #ifdef Z_HAS_RANDOM_MAP
     // Initialize inflate.
@@ -1538,6 +2063,11 @@ zio_index::build_index(FILE *in, unsigned int span)
 
     strm.avail_out = 0;
     do {
+        if (cancel && *cancel) {
+            inflateEnd(&strm);
+            return (Z_ERRNO);
+        }
+
         // Get some compressed data from input file.
         strm.avail_in = fread(input, 1, Z_INSIZE, in);
         if (ferror(in)) {
@@ -1620,11 +2150,115 @@ zio_index::build_index(FILE *in, unsigned int span)
 #else
     (void)in;
     (void)span;
+    (void)cancel;
     return (-1);
 #endif  // Z_HAS_RANDOM_MAP
 }
 
 
+// Static function.
+// Inflate the span starting at the access point here, reading the
+// compressed data from the file descriptor with pread so that this
+// can be called from several threads at once.  If want is nonzero,
+// that many bytes are inflated, otherwise inflation continues to the
+// end of the stream.  The buffer *pbuf of size *psize is reallocated
+// as needed.  When reading to the end and trailer is not null, the
+// 8-byte gzip trailer (CRC and size) is copied to it.  The return is
+// the number of bytes inflated, or a negative zlib error code.
+//
+int
+zio_index::inflate_span(int fd, const point_t *here, unsigned char **pbuf,
+    unsigned int *psize, uint64_t want, unsigned char *trailer)
+{
+#ifdef Z_HAS_AHEAD
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.avail_in = 0;
+    strm.next_in = Z_NULL;
+    int ret = inflateInit2(&strm, -MAX_WBITS);
+    if (ret != Z_OK)
+        return (ret);
+
+    unsigned char input[Z_INSIZE];
+    off_t in = here->in;
+    if (here->bits) {
+        if (pread(fd, input, 1, in - 1) != 1) {
+            inflateEnd(&strm);
+            return (Z_ERRNO);
+        }
+        inflatePrime(&strm, here->bits, input[0] >> (8 - here->bits));
+    }
+    inflateSetDictionary(&strm, here->window, Z_WINSIZE);
+
+    unsigned int size = want ? want : 4*Z_OUTSIZE;
+    if (!*pbuf || *psize < size) {
+        delete [] *pbuf;
+        *pbuf = new unsigned char[size];
+        *psize = size;
+    }
+    strm.next_out = *pbuf;
+    strm.avail_out = want ? size : *psize;
+
+    for (;;) {
+        if (strm.avail_in == 0) {
+            ssize_t n = pread(fd, input, Z_INSIZE, in);
+            if (n <= 0) {
+                inflateEnd(&strm);
+                return (n < 0 ? Z_ERRNO : Z_DATA_ERROR);
+            }
+            in += n;
+            strm.next_in = input;
+            strm.avail_in = n;
+        }
+        ret = inflate(&strm, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END)
+            break;
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            inflateEnd(&strm);
+            return (ret == Z_NEED_DICT ? Z_DATA_ERROR : ret);
+        }
+        if (strm.avail_out == 0) {
+            if (want)
+                break;
+
+            // Reading to the end, grow the buffer.
+            unsigned int nsz = *psize + *psize;
+            unsigned char *tmp = new unsigned char[nsz];
+            memcpy(tmp, *pbuf, *psize);
+            delete [] *pbuf;
+            strm.next_out = tmp + *psize;
+            strm.avail_out = nsz - *psize;
+            *pbuf = tmp;
+            *psize = nsz;
+        }
+    }
+    if (trailer) {
+        // Reading to the end, return the 8-byte gzip trailer that
+        // follows the deflate data.
+        unsigned int n = strm.avail_in < 8 ? strm.avail_in : 8;
+        memcpy(trailer, strm.next_in, n);
+        if (n < 8 && pread(fd, trailer + n, 8 - n, in) != (ssize_t)(8 - n)) {
+            inflateEnd(&strm);
+            return (Z_DATA_ERROR);
+        }
+    }
+    ret = strm.total_out;
+    inflateEnd(&strm);
+    return (ret);
+#else
+    (void)fd;
+    (void)here;
+    (void)pbuf;
+    (void)psize;
+    (void)want;
+    (void)trailer;
+    return (Z_ERRNO);
+#endif
+}
+
+
 #define ZI_MAGIC_STRING "Xic gzip file map 1.0"
 
 // Write a file representing the zio_index struct.  Format is
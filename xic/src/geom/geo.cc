@@ -56,6 +56,7 @@ cGEO::cGEO()
     geoElecRoundSides = DEF_RoundFlashSides;
     geoPhysRoundSides = DEF_RoundFlashSides;
     geoUseSclFuncs = false;
+    geoUseSweepFuncs = false;
 
     new cGEOmmgr;   // Memory manager.
 }
@@ -68,49 +68,12 @@ cGEOmmgr::cGEOmmgr() :
 void
 cGEOmmgr::stats(int *inuse, int *not_inuse)
 {
-    mmgrstat_t st;
-
-    RTelem_db.stats(&st);
-    st.print("RTelem", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    Zlist_db.stats(&st);
-    st.print("Zlist", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    Ylist_db.stats(&st);
-    st.print("Ylist", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    Blist_db.stats(&st);
-    st.print("Blist", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    BYlist_db.stats(&st);
-    st.print("BYlist", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
-
-    GEOblock_db.stats(&st);
-    st.print("GEOblock", stdout);
-    if (inuse)
-        *inuse += st.inuse*st.strsize;
-    if (not_inuse)
-        *not_inuse += st.not_inuse*st.strsize;
+    RTelem_db.print_stats(stdout, inuse, not_inuse);
+    Zlist_db.print_stats(stdout, inuse, not_inuse);
+    Ylist_db.print_stats(stdout, inuse, not_inuse);
+    Blist_db.print_stats(stdout, inuse, not_inuse);
+    BYlist_db.print_stats(stdout, inuse, not_inuse);
+    GEOblock_db.print_stats(stdout, inuse, not_inuse);
 }
 
 
@@ -206,8 +206,9 @@ namespace {
 
 
 // Unset "deferred mode", sort the objects, and create the actual
-// database tree.  Adding object in sorted order can be much faster
-// than adding objects in arbitrary order.
+// database tree.  The tree is built bottom-up from the sorted
+// objects, which is much faster than inserting objects one at a
+// time, and produces fully packed nodes.
 //
 bool
 RTree::unset_deferred()
@@ -234,15 +235,66 @@ RTree::unset_deferred()
     rt_allocated = 0;
     rt_deferred = false;
 
-    bool ok = true;
     for (unsigned int i = 0; i < cnt; i++) {
         ary[i]->e_right = 0;
         ary[i]->e_up = 0;
-        if (!insert_prv(ary[i]))
-            ok = false;
     }
+    load_sorted(ary, cnt);
+    rt_allocated = cnt;
     delete [] ary;
-    return (ok);
+    return (true);
+}
+
+
+// Private function to build the tree from cnt unlinked data elements
+// in database order, which is preserved.  Each level is constructed
+// from the level below, by linking consecutive runs of e_maxlinks
+// elements to a new node.  If the final run would be too short, the
+// final two nodes share the remaining elements, so that all nodes
+// other than the root have at least e_minlinks elements.  The array
+// is reused for each level.
+//
+void
+RTree::load_sorted(RTelem **ary, unsigned int cnt)
+{
+    if (!cnt)
+        return;
+    unsigned int maxl = RTelem::e_maxlinks;
+    unsigned int minl = RTelem::e_minlinks;
+    while (cnt > 1) {
+        unsigned int nn = 0;
+        for (unsigned int i = 0; i < cnt; ) {
+            unsigned int n = cnt - i;
+            if (n >= maxl + minl)
+                n = maxl;
+            else if (n > maxl)
+                n -= minl;
+
+            RTelem *p = new RTelem;
+            RTelem *rp = 0;
+            for (unsigned int j = i; j < i + n; j++) {
+                RTelem *r = ary[j];
+                r->set_parent(p);
+                if (!rp) {
+                    p->set_children(r);
+                    p->e_BB = r->e_BB;
+                }
+                else {
+                    rp->set_sibling(r);
+                    p->e_BB.add(&r->e_BB);
+                }
+                rp = r;
+            }
+            p->set_count(n);
+            i += n;
+
+            // The node count never exceeds the read position.
+            ary[nn++] = p;
+        }
+        cnt = nn;
+    }
+    rt_root = ary[0];
+    rt_root->set_parent(RT_ROOT_UP);
 }
 
 
@@ -343,6 +343,8 @@ Zlist::zl_andnot(Zlist **zl1p, Zlist *zl2)
         Zlist::destroy(zl2);
         return (XIok);
     }
+    if (GEO()->useSweepFuncs() && zl_sweepable(*zl1p, zl2))
+        return (zl_sweep(zl1p, zl2, ZLandnot));
 
     Ylist *yl = new Ylist(*zl1p);
     if (!zl2->next) {
@@ -470,6 +472,9 @@ Zlist::zl_xor(Zlist **zl1p, Zlist *zl2)
 {
     TimeDbgAccum ac("zl_xor");
 
+    if (GEO()->useSweepFuncs() && zl_sweepable(*zl1p, zl2))
+        return (zl_sweep(zl1p, zl2, ZLxor));
+
 #ifdef SCLDEBUG
     if (GEO()->useSclFuncs()) {
         Ylist *yl1 = new Ylist(*zl1p);
@@ -355,6 +355,49 @@ namespace {
         return (true);
     }
 
+    bool
+    evChdGzipThreads(const char *vstring, bool set)
+    {
+        if (set) {
+            int i;
+            if (str_to_int(&i, vstring) && i >= 1 && i <= 32)
+                FIO()->SetChdGzipThreads(i);
+            else {
+                Log()->ErrorLog(mh::Variables,
+                    "Incorrect ChdGzipThreads: requires integer 1-32.");
+                return (false);
+            }
+        }
+        else
+            FIO()->SetChdGzipThreads(1);
+        return (true);
+    }
+
+    bool
+    evChdFlatJobs(const char *vstring, bool set)
+    {
+        if (set) {
+            int i;
+            if (str_to_int(&i, vstring) && i >= 1 && i <= 64)
+                FIO()->SetChdFlatJobs(i);
+            else {
+                Log()->ErrorLog(mh::Variables,
+                    "Incorrect ChdFlatJobs: requires integer 1-64.");
+                return (false);
+            }
+        }
+        else
+            FIO()->SetChdFlatJobs(1);
+        return (true);
+    }
+
+    bool
+    evNoInputMmap(const char*, bool set)
+    {
+        FIO()->SetNoInputMmap(set);
+        return (true);
+    }
+
     bool
     evAutoRename(const char*, bool set)
     {
@@ -991,6 +1034,9 @@ cConvert::setupVariables()
     // Conversion - Import and Conversion Commands
     vsetup(VA_ChdLoadTopOnly,           B,  ev_update);
     vsetup(VA_ChdRandomGzip,            S,  evChdRandomGzip);
+    vsetup(VA_ChdGzipThreads,           S,  evChdGzipThreads);
+    vsetup(VA_ChdFlatJobs,              S,  evChdFlatJobs);
+    vsetup(VA_NoInputMmap,              B,  evNoInputMmap);
     vsetup(VA_AutoRename,               B,  evAutoRename);
     vsetup(VA_NoCreateLayer,            B,  evNoCreateLayer);
     vsetup(VA_NoAskOverwrite,           B,  ev_update);
@@ -125,6 +125,9 @@ namespace {
 
         // Clear user marks
         DSP()->ClearUserMarks(sdesc);
+
+        // Saved window images may show the cell.
+        DSP()->ClearImageCaches();
     }
 
     // The object odesc is being removed.  If save is true, the object is
@@ -135,6 +138,7 @@ namespace {
     {
         if (!sdesc || !odesc)
             return;
+        DSP()->DbChanged();
         Selections.removeObject(sdesc, odesc);
         EditIf()->invalidateObject(sdesc, odesc, save);
 
@@ -169,6 +173,7 @@ namespace {
     void
     ifInvalidateLayerContent(CDs *sd, CDl *ld)
     {
+        DSP()->DbChanged();
         if (sd)
             Selections.removeLayer(sd, ld);
         else
@@ -53,6 +53,8 @@ class ErrRec
 {
     static ErrRec *ptr()
         {
+            if (threadPtr)
+                return (threadPtr);
             if (!instancePtr) {
                 fprintf(stderr,
                     "Singleton class ErrRec used before instantiated.\n");
@@ -80,12 +82,32 @@ public:
             warnings_flag = false;
         }
 
+    // Constructor for a private record, used by a helper thread.
+    //
+    ErrRec(bool)
+        {
+            erMsgs = 0;
+            erStack = 0;
+            lastMsg = 0;
+            warnings = 0;
+            warnings_flag = false;
+        }
+
     ~ErrRec()
         {
-            instancePtr = 0;
+            if (instancePtr == this)
+                instancePtr = 0;
             clear();
         }
 
+    // Direct Errs() in the calling thread to the private record rec,
+    // or back to the main record if rec is null.  The main record is
+    // not thread-safe, so a helper thread that may record errors
+    // should use a private record, and pass the text to the main
+    // thread.
+    //
+    static void set_thread_rec(ErrRec *rec) { threadPtr = rec; }
+
     void clear()
         {
             stringlist::destroy(erMsgs);
@@ -153,6 +175,7 @@ private:
     bool warnings_flag;
 
     static ErrRec *instancePtr;
+    static __thread ErrRec *threadPtr;
 };
 
 #endif
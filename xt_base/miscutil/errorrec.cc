@@ -67,6 +67,7 @@
 //    sub-function call.
 
 ErrRec *ErrRec::instancePtr = 0;
+__thread ErrRec *ErrRec::threadPtr = 0;
 
 
 // Push an error string into the error recorder.